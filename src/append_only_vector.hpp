@@ -0,0 +1,164 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <utility>
+
+// Vetor concorrente do tipo 'append-only' ('segmented vector').
+//
+// Os elementos são armazenados em segmentos de tamanho geométrico (o segmento
+// 'k' possui 'FirstSegment << k' posições). Segmentos nunca são realocados,
+// portanto os endereços dos elementos são estáveis durante toda a vida do
+// container.
+//
+// '.push_back()' reserva a posição do novo elemento com um único
+// 'fetch_add' (sem laço de tentativas), constrói o elemento na posição
+// reservada e então o publica. A iteração pode ocorrer concorrentemente às
+// inserções e visita apenas os elementos já publicados.
+//
+// Não há remoção de elementos; a destruição do container não pode ser
+// concorrente às demais operações.
+template <typename T, std::size_t FirstSegment = 32>
+class append_only_vector {
+    static_assert(std::has_single_bit(FirstSegment),
+                  "'FirstSegment' deve ser uma potência de 2.");
+
+    struct slot {
+        std::atomic<bool> ready{false};
+        alignas(T) std::byte storage[sizeof(T)];
+
+        T* get() { return std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+    static constexpr std::size_t max_segments = 48;
+    static constexpr std::size_t first_bits = std::countr_zero(FirstSegment);
+
+    static std::size_t segment_size(std::size_t seg) {
+        return FirstSegment << seg;
+    }
+    // Índice global -> (segmento, posição dentro do segmento).
+    static std::pair<std::size_t, std::size_t> locate(std::size_t i) {
+        std::size_t biased = i + FirstSegment;
+        std::size_t seg = std::bit_width(biased) - 1 - first_bits;
+        return {seg, biased - (FirstSegment << seg)};
+    }
+
+   public:
+    using value_type = T;
+
+    append_only_vector() = default;
+    append_only_vector(const append_only_vector&) = delete;
+    append_only_vector& operator=(const append_only_vector&) = delete;
+
+    ~append_only_vector() {
+        for (std::size_t seg = 0; seg < max_segments; ++seg) {
+            slot* s = segments[seg].load(std::memory_order_acquire);
+            if (!s) break;
+            for (std::size_t j = 0; j < segment_size(seg); ++j) {
+                if (s[j].ready.load(std::memory_order_acquire)) {
+                    std::destroy_at(s[j].get());
+                }
+            }
+            delete[] s;
+        }
+    }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        auto i = reserved.fetch_add(1, std::memory_order_relaxed);
+        auto [seg, off] = locate(i);
+        slot& s = segment(seg)[off];
+        ::new (static_cast<void*>(s.storage)) T(std::forward<Args>(args)...);
+        s.ready.store(true, std::memory_order_release);
+        return *s.get();
+    }
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    // Número de posições já reservadas (publicadas ou ainda em construção).
+    std::size_t size() const {
+        return reserved.load(std::memory_order_acquire);
+    }
+
+    // Acesso a um elemento já publicado.
+    T& operator[](std::size_t i) {
+        auto [seg, off] = locate(i);
+        return *segments[seg].load(std::memory_order_acquire)[off].get();
+    }
+    const T& operator[](std::size_t i) const {
+        auto [seg, off] = locate(i);
+        return *segments[seg].load(std::memory_order_acquire)[off].get();
+    }
+
+    // Iterador sobre os elementos publicados até o momento da chamada de
+    // '.begin()'. Posições reservadas mas ainda em construção são ignoradas.
+    class iterator {
+       public:
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        iterator(append_only_vector* v, std::size_t i, std::size_t limit)
+            : v{v}, i{i}, limit{limit} {
+            skip_unpublished();
+        }
+
+        T& operator*() const { return (*v)[i]; }
+        T* operator->() const { return &(*v)[i]; }
+        iterator& operator++() {
+            ++i;
+            skip_unpublished();
+            return *this;
+        }
+        iterator operator++(int) {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        bool operator==(const iterator& o) const { return i == o.i; }
+        bool operator==(std::default_sentinel_t) const { return i >= limit; }
+
+       private:
+        void skip_unpublished() {
+            while (i < limit && !v->published(i)) ++i;
+        }
+
+        append_only_vector* v{nullptr};
+        std::size_t i{0};
+        std::size_t limit{0};
+    };
+
+    iterator begin() { return iterator{this, 0, size()}; }
+    std::default_sentinel_t end() { return {}; }
+
+   private:
+    bool published(std::size_t i) const {
+        auto [seg, off] = locate(i);
+        slot* s = segments[seg].load(std::memory_order_acquire);
+        return s && s[off].ready.load(std::memory_order_acquire);
+    }
+
+    // Retorna o segmento 'seg', alocando-o caso ainda não exista. Caso duas
+    // 'threads' tentem alocar o mesmo segmento, apenas uma vence o
+    // 'compare_exchange' e a outra descarta a sua alocação.
+    slot* segment(std::size_t seg) {
+        slot* s = segments[seg].load(std::memory_order_acquire);
+        if (s) return s;
+        slot* fresh = new slot[segment_size(seg)];
+        if (segments[seg].compare_exchange_strong(s, fresh,
+                                                  std::memory_order_acq_rel,
+                                                  std::memory_order_acquire)) {
+            return fresh;
+        }
+        delete[] fresh;
+        return s;
+    }
+
+    std::atomic<std::size_t> reserved{0};
+    std::array<std::atomic<slot*>, max_segments> segments{};
+};
@@ -0,0 +1,362 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "append_only_vector.hpp"
+#include "timestamp.hpp"
+
+// Política adotada quando o 'buffer' de uma 'thread' produtora está cheio.
+enum class overflow_policy {
+    drop,   // o registro é descartado (e contabilizado em '.dropped()').
+    block,  // a 'thread' produtora aguarda até que haja espaço.
+};
+
+// 'Logger' assíncrono com registros binários.
+//
+// Formatar a mensagem ('std::format') e escrevê-la na saída na própria 'thread'
+// chamadora (como em 'log_and_add' dos itens 26 e 27) custa centenas de
+// nanossegundos por chamada. Aqui, a 'thread' produtora apenas copia para um
+// registro de tamanho fixo o 'timestamp' cru ('tsc_clock::ticks()'), a
+// identificação do formato e os argumentos em forma binária. Cada 'thread'
+// produtora possui o seu próprio 'ring buffer' do tipo SPSC ('single
+// producer, single consumer'), de forma que não há disputa entre produtores.
+// Uma 'thread' de fundo percorre os 'buffers', formata os registros e os
+// escreve na saída em blocos grandes.
+//
+// - A identificação do formato é composta pela própria 'string' de formatação
+//   (que deve ser um literal, como garantido na prática por
+//   'std::format_string') e por uma função de decodificação instanciada para
+//   os tipos dos argumentos.
+// - Argumentos conversíveis para 'std::string_view' são copiados (e truncados
+//   caso não caibam no registro); os demais devem ser 'trivially copyable' e
+//   são copiados byte a byte.
+// - Os 'buffers' de 'threads' encerradas são reaproveitados por novas
+//   'threads'.
+//
+// O 'logger' deve ser destruído apenas quando nenhuma 'thread' estiver
+// registrando mensagens. Com 'overflow_policy::block', não se deve registrar
+// mensagens de dentro da escrita na saída ('sink').
+class async_logger {
+    // Argumentos do tipo 'string' são decodificados como 'std::string_view'
+    // apontando para o próprio registro.
+    template <typename T>
+    static constexpr bool is_string_arg =
+        std::convertible_to<const T&, std::string_view>;
+    template <typename T>
+    using decoded_t =
+        std::conditional_t<is_string_arg<T>, std::string_view, T>;
+
+   public:
+    static constexpr std::size_t record_size = 128;
+
+    explicit async_logger(
+        std::ostream& sink, overflow_policy policy = overflow_policy::drop,
+        std::size_t ring_capacity = 4096,
+        std::chrono::microseconds idle_interval = std::chrono::microseconds{
+            200})
+        : sink{sink},
+          policy{policy},
+          ring_capacity{std::bit_ceil(ring_capacity)},
+          idle_interval{idle_interval},
+          id{next_id()} {
+        {
+            std::scoped_lock lock{registry_mutex()};
+            live_loggers()[id] = this;
+        }
+        writer = std::jthread{[this](std::stop_token st) { write_loop(st); }};
+    }
+
+    async_logger(const async_logger&) = delete;
+    async_logger& operator=(const async_logger&) = delete;
+
+    // Escreve todos os registros pendentes e encerra a 'thread' de fundo.
+    ~async_logger() {
+        {
+            std::scoped_lock lock{registry_mutex()};
+            live_loggers().erase(id);
+        }
+        writer.request_stop();
+        writer.join();
+    }
+
+    // Registra uma mensagem. Retorna 'false' caso o registro tenha sido
+    // descartado ('overflow_policy::drop' com o 'buffer' cheio).
+    template <typename... Args>
+    bool log(std::format_string<decoded_t<Args>...> fmt, const Args&... args) {
+        static_assert(encoded_size<Args...>() <= payload_size,
+                      "Argumentos não cabem num registro do 'logger'.");
+        ring& r = local_ring();
+        auto t = r.tail.load(std::memory_order_relaxed);
+        if (t - r.cached_head > r.mask) {
+            r.cached_head = r.head.load(std::memory_order_acquire);
+            while (t - r.cached_head > r.mask) {
+                if (policy == overflow_policy::drop) {
+                    r.dropped.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                std::this_thread::yield();
+                r.cached_head = r.head.load(std::memory_order_acquire);
+            }
+        }
+        record& rec = r.slots[t & r.mask];
+        rec.ticks = tsc_clock::ticks();
+        rec.fmt = fmt.get();
+        rec.decode = &decode<Args...>;
+        std::byte* p = rec.payload;
+        encode_all(p, rec.payload + payload_size, args...);
+        r.tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Aguarda até que todos os registros feitos antes da chamada tenham sido
+    // escritos na saída.
+    //
+    // O pedido é registrado antes da leitura de 'rounds' (ambos
+    // 'seq_cst'): a rodada seguinte à rodada em andamento começa após o
+    // pedido e, portanto, o observa, drena os registros e escreve a saída
+    // antes de '.flush()' na 'sink'.
+    void flush() {
+        flush_requested.store(true, std::memory_order_seq_cst);
+        auto target = rounds.load(std::memory_order_seq_cst) + 2;
+        while (rounds.load(std::memory_order_acquire) < target) {
+            std::this_thread::yield();
+        }
+    }
+
+    // Número de registros descartados por falta de espaço.
+    std::size_t dropped() {
+        std::size_t total = 0;
+        for (auto& r : rings) {
+            total += r->dropped.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+   private:
+    struct record;
+    using decode_fn = void (*)(const record&, std::string&);
+
+    struct record {
+        std::uint64_t ticks;
+        std::string_view fmt;
+        decode_fn decode;
+        std::byte payload[record_size - 32];
+    };
+    static constexpr std::size_t payload_size = sizeof(record::payload);
+    static_assert(sizeof(record) == record_size);
+
+    // Tamanho mínimo ocupado pelos argumentos ('strings' vazias).
+    template <typename... Args>
+    static constexpr std::size_t encoded_size() {
+        return (std::size_t{0} + ... +
+                (is_string_arg<Args> ? sizeof(std::uint16_t) : sizeof(Args)));
+    }
+
+    // Cada 'string' é truncada de forma a preservar o espaço mínimo dos
+    // argumentos seguintes.
+    static void encode_all(std::byte*&, std::byte*) {}
+    template <typename T, typename... Rest>
+    static void encode_all(std::byte*& p, std::byte* end, const T& v,
+                           const Rest&... rest) {
+        encode(p, end - encoded_size<Rest...>(), v);
+        encode_all(p, end, rest...);
+    }
+
+    template <typename T>
+    static void encode(std::byte*& p, std::byte* end, const T& v) {
+        if constexpr (is_string_arg<T>) {
+            std::string_view s = v;
+            auto room =
+                static_cast<std::size_t>(end - p) - sizeof(std::uint16_t);
+            auto n = static_cast<std::uint16_t>(std::min(s.size(), room));
+            std::memcpy(p, &n, sizeof(n));
+            std::memcpy(p + sizeof(n), s.data(), n);
+            p += sizeof(n) + n;
+        } else {
+            static_assert(std::is_trivially_copyable_v<T>,
+                          "Argumentos do 'logger' devem ser 'strings' ou "
+                          "'trivially copyable'.");
+            std::memcpy(p, &v, sizeof(T));
+            p += sizeof(T);
+        }
+    }
+
+    template <typename T>
+    static decoded_t<T> decode_one(const std::byte*& p) {
+        if constexpr (is_string_arg<T>) {
+            std::uint16_t n;
+            std::memcpy(&n, p, sizeof(n));
+            std::string_view s{reinterpret_cast<const char*>(p + sizeof(n)),
+                               n};
+            p += sizeof(n) + n;
+            return s;
+        } else {
+            T v;
+            std::memcpy(&v, p, sizeof(T));
+            p += sizeof(T);
+            return v;
+        }
+    }
+
+    template <typename... Args>
+    static void decode(const record& rec, std::string& out) {
+        const std::byte* p = rec.payload;
+        // A ordem de avaliação dentro de uma lista entre chaves é garantida
+        // (da esquerda para a direita).
+        std::tuple<decoded_t<Args>...> values{decode_one<Args>(p)...};
+        std::apply(
+            [&](auto&... v) {
+                std::vformat_to(std::back_inserter(out), rec.fmt,
+                                std::make_format_args(v...));
+            },
+            values);
+    }
+
+    // 'head' e 'tail' em linhas de cache distintas para que produtor e
+    // consumidor não disputem a mesma linha a cada registro.
+    struct ring {
+        explicit ring(std::size_t capacity)
+            : mask{capacity - 1},
+              slots{std::make_unique<record[]>(capacity)} {}
+
+        alignas(64) std::atomic<std::size_t> head{0};  // consumidor.
+        alignas(64) std::atomic<std::size_t> tail{0};  // produtor.
+        std::size_t cached_head{0};  // cópia local do produtor.
+        std::atomic<std::size_t> dropped{0};
+        alignas(64) std::atomic<bool> in_use{true};
+        const std::size_t mask;
+        const std::unique_ptr<record[]> slots;
+    };
+
+    // Formata os registros pendentes de todos os 'buffers' em 'out'. Retorna
+    // o número de registros processados.
+    std::size_t drain(std::string& out) {
+        std::size_t count = 0;
+        for (auto& r : rings) {
+            auto h = r->head.load(std::memory_order_relaxed);
+            auto t = r->tail.load(std::memory_order_acquire);
+            for (; h != t; ++h) {
+                const record& rec = r->slots[h & r->mask];
+                auto sys = tsc_clock::to_sys(tsc_clock::from_ticks(rec.ticks));
+                std::format_to(std::back_inserter(out), "[{}] ", sys);
+                rec.decode(rec, out);
+                out.push_back('\n');
+                ++count;
+                if (out.size() >= batch_bytes) {
+                    r->head.store(h + 1, std::memory_order_release);
+                    write(out);
+                }
+            }
+            r->head.store(h, std::memory_order_release);
+        }
+        return count;
+    }
+
+    void write(std::string& out) {
+        sink.write(out.data(), static_cast<std::streamsize>(out.size()));
+        out.clear();
+    }
+
+    void write_loop(std::stop_token st) {
+        std::string out;
+        out.reserve(batch_bytes + 1024);
+        while (!st.stop_requested()) {
+            // O pedido de '.flush()' é consumido antes de 'drain()', de forma
+            // que os registros anteriores ao pedido sejam escritos nesta
+            // mesma rodada.
+            bool flush_now =
+                flush_requested.exchange(false, std::memory_order_seq_cst);
+            auto count = drain(out);
+            if (!out.empty()) write(out);
+            if (flush_now) sink.flush();
+            rounds.fetch_add(1, std::memory_order_seq_cst);
+            if (count == 0) std::this_thread::sleep_for(idle_interval);
+        }
+        drain(out);
+        write(out);
+        sink.flush();
+    }
+
+    // Associação 'thread' -> 'buffer', indexada pelo 'id' do 'logger' (nunca
+    // reutilizado), como em 'epoch_domain' (./epoch_reclamation.hpp). Ao
+    // término da 'thread', os 'buffers' de 'loggers' ainda vivos são
+    // liberados para reaproveitamento.
+    struct thread_cache {
+        std::vector<std::pair<std::uint64_t, ring*>> entries;
+        ~thread_cache() {
+            std::scoped_lock lock{registry_mutex()};
+            for (auto [logger_id, r] : entries) {
+                if (live_loggers().contains(logger_id)) {
+                    r->in_use.store(false, std::memory_order_release);
+                }
+            }
+        }
+    };
+
+    ring& local_ring() {
+        thread_local thread_cache cache;
+        for (auto [logger_id, r] : cache.entries) {
+            if (logger_id == id) return *r;
+        }
+        ring* found = nullptr;
+        for (auto& r : rings) {
+            bool expected = false;
+            if (r->in_use.compare_exchange_strong(expected, true,
+                                                  std::memory_order_acq_rel)) {
+                found = r.get();
+                break;
+            }
+        }
+        if (!found) {
+            found = rings.emplace_back(std::make_unique<ring>(ring_capacity))
+                        .get();
+        }
+        cache.entries.emplace_back(id, found);
+        return *found;
+    }
+
+    static std::uint64_t next_id() {
+        static std::atomic<std::uint64_t> counter{0};
+        return counter.fetch_add(1, std::memory_order_relaxed);
+    }
+    static std::mutex& registry_mutex() {
+        static std::mutex m;
+        return m;
+    }
+    static std::unordered_map<std::uint64_t, async_logger*>& live_loggers() {
+        static std::unordered_map<std::uint64_t, async_logger*> m;
+        return m;
+    }
+
+    static constexpr std::size_t batch_bytes = 64 * 1024;
+
+    std::ostream& sink;
+    const overflow_policy policy;
+    const std::size_t ring_capacity;
+    const std::chrono::microseconds idle_interval;
+    const std::uint64_t id;
+    append_only_vector<std::unique_ptr<ring>> rings;
+    std::atomic<std::uint64_t> rounds{0};
+    std::atomic<bool> flush_requested{false};
+    std::jthread writer;
+};
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <chrono>
+#include <utility>
+
+// Utilitário mínimo para as medições de desempenho realizadas nos blocos de
+// demonstração dos itens. Retorna o tempo decorrido, em milissegundos, da
+// execução de 'f'.
+template <typename F>
+double time_ms(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    std::forward<F>(f)();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Impede que o compilador elimine o cálculo de 'value' como código morto
+// durante as medições.
+template <typename T>
+void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
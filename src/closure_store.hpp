@@ -0,0 +1,179 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Armazenamento de 'callbacks' separado por tipo concreto.
+//
+// Num 'vector<std::function<int()>>' (item_31), cada invocação é um salto
+// indireto para um destino diferente e, para capturas grandes, um acesso a
+// um bloco de memória separado na 'heap'. Aqui, os invocáveis são agrupados
+// pelo seu tipo concreto (cada 'lambda' possui o seu próprio tipo), e cada
+// grupo é armazenado contiguamente num arranjo do próprio tipo. Em
+// '.invoke_all()' há apenas uma chamada indireta por grupo, seguida de um laço
+// sobre o arranjo em que a chamada de cada invocável pode ser expandida
+// ('inlined') pelo compilador.
+//
+// - '.push_back()' retorna um 'handle', com o qual o invocável pode ser
+//   removido em O(1) ('.erase()'). 'handles' de invocáveis já removidos são
+//   reconhecidos e ignorados.
+// - A remoção move o último invocável do grupo para a posição removida:
+//   a ordem de invocação é a dos grupos e, dentro de cada grupo, não
+//   necessariamente a de inserção.
+// - Os argumentos de '.invoke_all()' são repassados como 'lvalues' para todos
+//   os invocáveis.
+template <typename Signature>
+class closure_store;
+
+template <typename R, typename... Args>
+class closure_store<R(Args...)> {
+    static constexpr std::uint32_t no_slot = UINT32_MAX;
+
+    // Índice global (compartilhado por todas as instâncias de
+    // 'closure_store') de cada tipo de invocável, utilizado para localizar o
+    // seu grupo sem busca.
+    static std::uint32_t next_type_index() {
+        static std::atomic<std::uint32_t> counter{0};
+        return counter.fetch_add(1, std::memory_order_relaxed);
+    }
+    template <typename F>
+    static inline const std::uint32_t type_index = next_type_index();
+
+    struct group_base {
+        virtual ~group_base() = default;
+        virtual void invoke_all(Args&... args) = 0;
+        virtual void invoke_all(std::vector<R>& results, Args&... args) = 0;
+        virtual void erase(std::uint32_t pos) noexcept = 0;
+
+        std::vector<std::uint32_t> ids;  // 'id' de cada posição.
+    };
+
+    template <typename F>
+    struct group final : group_base {
+        void invoke_all(Args&... args) override {
+            for (auto& f : items) std::invoke(f, args...);
+        }
+        void invoke_all(std::vector<R>& results, Args&... args) override {
+            if constexpr (!std::is_void_v<R>) {
+                for (auto& f : items) {
+                    results.push_back(std::invoke_r<R>(f, args...));
+                }
+            }
+        }
+        // Os tipos das 'lambdas' não possuem atribuição: o último invocável
+        // é reconstruído na posição removida.
+        void erase(std::uint32_t pos) noexcept override {
+            if (pos + 1 != items.size()) {
+                std::destroy_at(&items[pos]);
+                std::construct_at(&items[pos], std::move(items.back()));
+                this->ids[pos] = this->ids.back();
+            }
+            items.pop_back();
+            this->ids.pop_back();
+        }
+
+        std::vector<F> items;
+    };
+
+    // Localização de cada 'id' (posição no grupo e geração, incrementada a
+    // cada remoção para invalidar os 'handles' antigos).
+    struct slot {
+        std::uint32_t pos;
+        std::uint32_t generation;
+    };
+
+   public:
+    struct handle {
+        std::uint32_t type{no_slot};
+        std::uint32_t id{no_slot};
+        std::uint32_t generation{0};
+
+        bool operator==(const handle&) const = default;
+    };
+
+    closure_store() = default;
+    closure_store(closure_store&&) noexcept = default;
+    closure_store& operator=(closure_store&&) noexcept = default;
+
+    template <typename Fn, typename F = std::decay_t<Fn>>
+        requires std::is_invocable_r_v<R, F&, Args&...>
+    handle push_back(Fn&& fn) {
+        static_assert(std::is_nothrow_move_constructible_v<F>,
+                      "O invocável deve ser 'nothrow move constructible'.");
+        auto type = type_index<F>;
+        if (type >= groups.size()) groups.resize(type + 1);
+        if (!groups[type]) groups[type] = std::make_unique<group<F>>();
+        auto& g = static_cast<group<F>&>(*groups[type]);
+
+        // Toda alocação ocorre antes de qualquer modificação, de forma que
+        // uma exceção não deixe o 'closure_store' inconsistente ('free_ids'
+        // comporta todos os 'ids', para que '.erase()' nunca aloque).
+        if (free_ids.empty()) {
+            slots.reserve(slots.size() + 1);
+            free_ids.reserve(slots.size() + 1);
+        }
+        g.ids.reserve(g.ids.size() + 1);
+        g.items.push_back(std::forward<Fn>(fn));
+
+        std::uint32_t id;
+        if (free_ids.empty()) {
+            id = static_cast<std::uint32_t>(slots.size());
+            slots.push_back({no_slot, 0});
+        } else {
+            id = free_ids.back();
+            free_ids.pop_back();
+        }
+        g.ids.push_back(id);
+        slots[id].pos = static_cast<std::uint32_t>(g.items.size() - 1);
+        ++count;
+        return {type, id, slots[id].generation};
+    }
+
+    // Remove o invocável de 'h'. Retorna 'false' caso já tenha sido removido.
+    bool erase(handle h) noexcept {
+        if (!contains(h)) return false;
+        auto& g = *groups[h.type];
+        auto pos = slots[h.id].pos;
+        auto moved = g.ids.back();
+        g.erase(pos);
+        slots[moved].pos = pos;
+        slots[h.id] = {no_slot, slots[h.id].generation + 1};
+        free_ids.push_back(h.id);
+        --count;
+        return true;
+    }
+
+    bool contains(handle h) const {
+        return h.id < slots.size() && slots[h.id].pos != no_slot &&
+               slots[h.id].generation == h.generation;
+    }
+
+    void invoke_all(Args... args) {
+        for (auto& g : groups) {
+            if (g && !g->ids.empty()) g->invoke_all(args...);
+        }
+    }
+    // Acrescenta a 'results' o resultado de cada invocação.
+    void invoke_all(std::vector<R>& results, Args... args)
+        requires(!std::is_void_v<R>)
+    {
+        results.reserve(results.size() + count);
+        for (auto& g : groups) {
+            if (g && !g->ids.empty()) g->invoke_all(results, args...);
+        }
+    }
+
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+   private:
+    std::vector<std::unique_ptr<group_base>> groups;  // por 'type_index'.
+    std::vector<slot> slots;                          // por 'id'.
+    std::vector<std::uint32_t> free_ids;
+    std::size_t count{0};
+};
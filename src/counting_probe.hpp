@@ -0,0 +1,211 @@
+#pragma once
+
+#include <atomic>
+#include <boost/type_index.hpp>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Instrumentação genérica de construções, cópias e movimentações.
+//
+// 'CountingProbe<T>' envolve um valor do tipo 'T' e contabiliza, num registro
+// global por tipo, cada operação especial realizada sobre o 'wrapper'. Assim
+// como 'Foo' e 'MoveOnlyFoo' do item_41, mas sem precisar reescrever os
+// contadores em cada classe, e com contagens agregadas por tipo ao invés de
+// por instância. 'ProbeScope<T>' registra as contagens no momento da sua
+// construção, permitindo obter apenas as operações realizadas dentro de um
+// trecho de código (eg, verificar que um caminho não realiza nenhuma cópia).
+
+struct ProbeCounts {
+    long default_ctor{0};
+    long value_ctor{0};
+    long copy_ctor{0};
+    long move_ctor{0};
+    long copy_assign{0};
+    long move_assign{0};
+    long dtor{0};
+    long swaps{0};
+
+    long copies() const { return copy_ctor + copy_assign; }
+    long moves() const { return move_ctor + move_assign; }
+    long constructions() const {
+        return default_ctor + value_ctor + copy_ctor + move_ctor;
+    }
+
+    ProbeCounts operator-(const ProbeCounts& o) const {
+        return {default_ctor - o.default_ctor, value_ctor - o.value_ctor,
+                copy_ctor - o.copy_ctor,       move_ctor - o.move_ctor,
+                copy_assign - o.copy_assign,   move_assign - o.move_assign,
+                dtor - o.dtor,                 swaps - o.swaps};
+    }
+    bool operator==(const ProbeCounts&) const = default;
+
+    friend std::ostream& operator<<(std::ostream& os, const ProbeCounts& c) {
+        return os << "default_ctor: " << c.default_ctor
+                  << "  value_ctor: " << c.value_ctor
+                  << "  copy_ctor: " << c.copy_ctor
+                  << "  move_ctor: " << c.move_ctor
+                  << "  copy_assign: " << c.copy_assign
+                  << "  move_assign: " << c.move_assign
+                  << "  dtor: " << c.dtor << "  swaps: " << c.swaps;
+    }
+};
+
+// Registro global dos contadores. Os contadores são atômicos para que a
+// instrumentação possa ser utilizada em código concorrente.
+class ProbeRegistry {
+   public:
+    struct Counters {
+        std::atomic<long> default_ctor{0};
+        std::atomic<long> value_ctor{0};
+        std::atomic<long> copy_ctor{0};
+        std::atomic<long> move_ctor{0};
+        std::atomic<long> copy_assign{0};
+        std::atomic<long> move_assign{0};
+        std::atomic<long> dtor{0};
+        std::atomic<long> swaps{0};
+
+        ProbeCounts load() const {
+            auto r = std::memory_order_relaxed;
+            return {default_ctor.load(r), value_ctor.load(r),
+                    copy_ctor.load(r),    move_ctor.load(r),
+                    copy_assign.load(r),  move_assign.load(r),
+                    dtor.load(r),         swaps.load(r)};
+        }
+    };
+
+    // Contadores do tipo 'T' (criados e registrados no primeiro acesso).
+    template <typename T>
+    static Counters& of() {
+        static Counters& c = add(boost::typeindex::type_id<T>().pretty_name());
+        return c;
+    }
+
+    template <typename T>
+    static ProbeCounts counts() {
+        return of<T>().load();
+    }
+
+    // Imprime as contagens de todos os tipos instrumentados até o momento.
+    static void report(std::ostream& os) {
+        std::scoped_lock lock{mutex()};
+        for (auto& [name, c] : entries()) {
+            os << name << ": " << c->load() << '\n';
+        }
+    }
+
+   private:
+    static Counters& add(std::string name) {
+        std::scoped_lock lock{mutex()};
+        auto& e = entries();
+        e.emplace_back(std::move(name), new Counters{});
+        return *e.back().second;
+    }
+    static std::mutex& mutex() {
+        static std::mutex m;
+        return m;
+    }
+    // Os contadores nunca são liberados, pois podem ser acessados até o fim
+    // da execução do programa (inclusive por destrutores de objetos
+    // estáticos).
+    static std::vector<std::pair<std::string, Counters*>>& entries() {
+        static std::vector<std::pair<std::string, Counters*>> e;
+        return e;
+    }
+};
+
+template <typename T>
+class CountingProbe {
+    static ProbeRegistry::Counters& counters() {
+        return ProbeRegistry::of<T>();
+    }
+    static void bump(std::atomic<long>& c) {
+        c.fetch_add(1, std::memory_order_relaxed);
+    }
+
+   public:
+    CountingProbe()
+        requires std::is_default_constructible_v<T>
+    {
+        bump(counters().default_ctor);
+    }
+
+    template <typename... Args>
+        requires std::is_constructible_v<T, Args...>
+    explicit CountingProbe(std::in_place_t, Args&&... args)
+        : value(std::forward<Args>(args)...) {
+        bump(counters().value_ctor);
+    }
+
+    template <typename U>
+        requires(!std::is_same_v<std::remove_cvref_t<U>, CountingProbe> &&
+                 !std::is_same_v<std::remove_cvref_t<U>, std::in_place_t> &&
+                 std::is_constructible_v<T, U>)
+    CountingProbe(U&& u) : value(std::forward<U>(u)) {
+        bump(counters().value_ctor);
+    }
+
+    CountingProbe(const CountingProbe& o)
+        requires std::is_copy_constructible_v<T>
+        : value(o.value) {
+        bump(counters().copy_ctor);
+    }
+    CountingProbe(CountingProbe&& o) noexcept(
+        std::is_nothrow_move_constructible_v<T>)
+        requires std::is_move_constructible_v<T>
+        : value(std::move(o.value)) {
+        bump(counters().move_ctor);
+    }
+
+    CountingProbe& operator=(const CountingProbe& o)
+        requires std::is_copy_assignable_v<T>
+    {
+        value = o.value;
+        bump(counters().copy_assign);
+        return *this;
+    }
+    CountingProbe& operator=(CountingProbe&& o) noexcept(
+        std::is_nothrow_move_assignable_v<T>)
+        requires std::is_move_assignable_v<T>
+    {
+        value = std::move(o.value);
+        bump(counters().move_assign);
+        return *this;
+    }
+
+    ~CountingProbe() { bump(counters().dtor); }
+
+    // 'swap' não é contabilizado como 3 movimentações, mas como 1 operação
+    // de 'swap' própria.
+    friend void swap(CountingProbe& a, CountingProbe& b) noexcept(
+        std::is_nothrow_swappable_v<T>) {
+        using std::swap;
+        swap(a.value, b.value);
+        bump(counters().swaps);
+    }
+
+    T& get() { return value; }
+    const T& get() const { return value; }
+    T& operator*() { return value; }
+    const T& operator*() const { return value; }
+    T* operator->() { return &value; }
+    const T* operator->() const { return &value; }
+
+   private:
+    T value{};
+};
+
+// Escopo RAII que registra as contagens de 'CountingProbe<T>' na sua
+// construção. '.delta()' retorna as operações realizadas desde então.
+template <typename T>
+class ProbeScope {
+   public:
+    ProbeScope() : start{ProbeRegistry::counts<T>()} {}
+    ProbeCounts delta() const { return ProbeRegistry::counts<T>() - start; }
+
+   private:
+    ProbeCounts start;
+};
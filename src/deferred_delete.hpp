@@ -0,0 +1,128 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <thread>
+#include <utility>
+
+// Fila de destruição adiada ('deferred reclamation').
+//
+// Quando o último 'std::shared_ptr' de um objeto grande (eg, um 'Widget' com
+// um 'std::vector<double>' extenso, ou um grafo de 'Widget2') é destruído, o
+// destrutor do recurso é executado na 'thread' que liberou o ponteiro,
+// interrompendo-a até o fim da desalocação. Com 'deferred_deleter<T>', o
+// objeto é apenas inserido numa fila 'lock-free' e a destruição efetiva
+// acontece numa 'thread' de fundo, que esvazia a fila em lotes a cada
+// 'drain_interval'. Os produtores não notificam a 'thread' de fundo:
+// acordá-la a cada inserção faria com que o escalonador a executasse
+// justamente no momento em que se deseja evitar a pausa.
+//
+// A fila possui capacidade limitada ('max_backlog'): caso esteja cheia, o
+// objeto é destruído imediatamente na própria 'thread' chamadora, de forma que
+// a memória pendente de liberação nunca cresça indefinidamente.
+class reclamation_queue {
+   public:
+    explicit reclamation_queue(
+        std::size_t max_backlog = 4096,
+        std::chrono::microseconds drain_interval = std::chrono::milliseconds{1})
+        : max_backlog{max_backlog},
+          drain_interval{drain_interval},
+          drainer{[this](std::stop_token st) { drain_loop(st); }} {}
+
+    reclamation_queue(const reclamation_queue&) = delete;
+    reclamation_queue& operator=(const reclamation_queue&) = delete;
+
+    // Encerra a 'thread' de fundo e destrói os objetos ainda pendentes.
+    ~reclamation_queue() {
+        drainer.request_stop();
+        drainer.join();
+        destroy_all(head.exchange(nullptr, std::memory_order_acquire));
+    }
+
+    // Enfileira 'p' para destruição pela 'thread' de fundo. Retorna 'false'
+    // (e destrói 'p' imediatamente) caso a fila esteja cheia ou caso não haja
+    // memória para o nó da fila.
+    template <typename T>
+    bool retire(T* p) {
+        // O nó é alocado antes da reserva da vaga, de forma que uma falha de
+        // alocação não deixe 'pending' incrementado (nem 'p' sem dono).
+        auto* n = new (std::nothrow)
+            node{p, [](void* obj) { delete static_cast<T*>(obj); }, nullptr};
+        if (!n) {
+            delete p;
+            return false;
+        }
+        // A vaga na fila é reservada antes da inserção, de forma que 'pending'
+        // nunca seja menor que o número de nós efetivamente enfileirados.
+        auto before = pending.fetch_add(1, std::memory_order_acq_rel);
+        if (before >= max_backlog) {
+            pending.fetch_sub(1, std::memory_order_relaxed);
+            delete n;
+            delete p;
+            return false;
+        }
+        n->next = head.load(std::memory_order_relaxed);
+        // 'push' numa pilha de Treiber: múltiplos produtores sem 'locks'.
+        while (!head.compare_exchange_weak(n->next, n,
+                                           std::memory_order_release,
+                                           std::memory_order_relaxed)) {
+        }
+        return true;
+    }
+
+    std::size_t backlog() const {
+        return pending.load(std::memory_order_relaxed);
+    }
+
+   private:
+    struct node {
+        void* obj;
+        void (*destroy)(void*);
+        node* next;
+    };
+
+    static std::size_t destroy_all(node* n) {
+        std::size_t count = 0;
+        while (n) {
+            node* next = n->next;
+            n->destroy(n->obj);
+            delete n;
+            n = next;
+            ++count;
+        }
+        return count;
+    }
+
+    void drain_loop(std::stop_token st) {
+        while (!st.stop_requested()) {
+            std::this_thread::sleep_for(drain_interval);
+            // O lote inteiro é retirado de uma só vez, e então liberado.
+            node* batch = head.exchange(nullptr, std::memory_order_acquire);
+            pending.fetch_sub(destroy_all(batch), std::memory_order_relaxed);
+        }
+    }
+
+    const std::size_t max_backlog;
+    const std::chrono::microseconds drain_interval;
+    std::atomic<node*> head{nullptr};
+    std::atomic<std::size_t> pending{0};
+    std::jthread drainer;
+};
+
+// 'deleter' para 'std::shared_ptr'/'std::unique_ptr' que repassa o objeto para
+// uma 'reclamation_queue' ao invés de destruí-lo diretamente.
+template <typename T>
+struct deferred_deleter {
+    reclamation_queue* queue;
+    void operator()(T* p) const { queue->retire(p); }
+};
+
+template <typename T, typename... Args>
+std::shared_ptr<T> make_deferred_shared(reclamation_queue& queue,
+                                        Args&&... args) {
+    return std::shared_ptr<T>(new T(std::forward<Args>(args)...),
+                              deferred_deleter<T>{&queue});
+}
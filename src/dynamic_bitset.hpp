@@ -0,0 +1,285 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// Conjunto de bits de tamanho dinâmico, sem classes 'proxy'.
+//
+// 'std::vector<bool>' (item_6) retorna de 'operator[]' um objeto 'proxy'
+// ('std::_Bit_reference'), que confunde a dedução de 'auto', e as operações
+// são feitas bit a bit, o que impede a vetorização. Aqui, a leitura
+// ('operator[]', '.test()') retorna 'bool' e a escrita é feita por métodos
+// explícitos ('.set()', '.reset()', '.flip()'). Os bits são armazenados em
+// palavras de 64 bits, acessíveis diretamente ('.words()'), e as operações em
+// lote ('&=', '|=', '^=', '.and_not()', '.count()') processam palavras
+// inteiras (com AVX2, 256 bits por instrução, selecionado em tempo de
+// compilação como em ./ipv4_columns.hpp).
+//
+// Os bits da última palavra além de '.size()' são sempre zero.
+class dynamic_bitset {
+   public:
+    using word_type = std::uint64_t;
+    static constexpr std::size_t word_bits = 64;
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    // Iteração sobre as posições dos bits ligados, palavra a palavra, com
+    // 'std::countr_zero'.
+    class set_bits_view {
+       public:
+        class iterator {
+           public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = std::size_t;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const std::size_t*;
+            using reference = std::size_t;
+
+            iterator() = default;
+
+            std::size_t operator*() const {
+                return w * word_bits +
+                       static_cast<std::size_t>(std::countr_zero(bits));
+            }
+            iterator& operator++() {
+                bits &= bits - 1;
+                if (!bits) advance();
+                return *this;
+            }
+            iterator operator++(int) {
+                auto tmp = *this;
+                ++*this;
+                return tmp;
+            }
+            bool operator==(const iterator& o) const {
+                return w == o.w && bits == o.bits;
+            }
+
+           private:
+            friend class set_bits_view;
+            iterator(std::span<const word_type> words, std::size_t w)
+                : words{words}, w{w} {
+                if (w < words.size()) {
+                    bits = words[w];
+                    if (!bits) advance();
+                }
+            }
+            // Próxima palavra com algum bit ligado.
+            void advance() {
+                while (++w < words.size()) {
+                    if ((bits = words[w])) return;
+                }
+                w = words.size();
+                bits = 0;
+            }
+
+            std::span<const word_type> words;
+            std::size_t w{0};
+            word_type bits{0};
+        };
+
+        iterator begin() const { return {words, 0}; }
+        iterator end() const { return {words, words.size()}; }
+
+       private:
+        friend class dynamic_bitset;
+        explicit set_bits_view(std::span<const word_type> words)
+            : words{words} {}
+
+        std::span<const word_type> words;
+    };
+
+    // Construtores:
+    dynamic_bitset() = default;
+    explicit dynamic_bitset(std::size_t n, bool value = false) {
+        resize(n, value);
+    }
+    dynamic_bitset(std::initializer_list<bool> il) {
+        resize(il.size());
+        std::size_t i = 0;
+        for (bool b : il) set(i++, b);
+    }
+
+    // Acesso aos bits:
+    bool operator[](std::size_t i) const {
+        return (words_[i / word_bits] >> (i % word_bits)) & 1;
+    }
+    bool test(std::size_t i) const {
+        if (i >= size_) throw std::out_of_range("dynamic_bitset::test");
+        return (*this)[i];
+    }
+    dynamic_bitset& set(std::size_t i, bool value = true) {
+        auto& w = words_[i / word_bits];
+        auto bit = word_type{1} << (i % word_bits);
+        w = value ? (w | bit) : (w & ~bit);
+        return *this;
+    }
+    dynamic_bitset& reset(std::size_t i) { return set(i, false); }
+    dynamic_bitset& flip(std::size_t i) {
+        words_[i / word_bits] ^= word_type{1} << (i % word_bits);
+        return *this;
+    }
+
+    // Acesso às palavras. Após escrever diretamente em '.words()', os bits
+    // além de '.size()' devem permanecer zerados.
+    std::span<word_type> words() noexcept { return words_; }
+    std::span<const word_type> words() const noexcept { return words_; }
+
+    // Tamanho:
+    std::size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+    void resize(std::size_t n, bool value = false) {
+        auto old_size = size_;
+        words_.resize((n + word_bits - 1) / word_bits,
+                      value ? ~word_type{0} : word_type{0});
+        size_ = n;
+        if (value && n > old_size && old_size % word_bits) {
+            // Bits novos na antiga última palavra.
+            words_[old_size / word_bits] |= ~word_type{0}
+                                            << (old_size % word_bits);
+        }
+        clear_tail();
+    }
+    void clear() noexcept {
+        words_.clear();
+        size_ = 0;
+    }
+
+    // Operações em lote (os dois conjuntos devem ter o mesmo tamanho):
+    dynamic_bitset& operator&=(const dynamic_bitset& o) {
+        return apply(o, [](auto a, auto b) { return a & b; });
+    }
+    dynamic_bitset& operator|=(const dynamic_bitset& o) {
+        return apply(o, [](auto a, auto b) { return a | b; });
+    }
+    dynamic_bitset& operator^=(const dynamic_bitset& o) {
+        return apply(o, [](auto a, auto b) { return a ^ b; });
+    }
+    // '*this &= ~o', sem construir '~o'.
+    dynamic_bitset& and_not(const dynamic_bitset& o) {
+        return apply(o, [](auto a, auto b) { return a & ~b; });
+    }
+    dynamic_bitset& flip() noexcept {
+        for (auto& w : words_) w = ~w;
+        clear_tail();
+        return *this;
+    }
+
+    friend dynamic_bitset operator&(dynamic_bitset a, const dynamic_bitset& b) {
+        return a &= b;
+    }
+    friend dynamic_bitset operator|(dynamic_bitset a, const dynamic_bitset& b) {
+        return a |= b;
+    }
+    friend dynamic_bitset operator^(dynamic_bitset a, const dynamic_bitset& b) {
+        return a ^= b;
+    }
+    friend dynamic_bitset operator~(dynamic_bitset a) { return a.flip(); }
+
+    // Consultas:
+    std::size_t count() const noexcept {
+        return popcount(words_.data(), words_.size());
+    }
+    bool any() const noexcept {
+        return std::ranges::any_of(words_, [](word_type w) { return w; });
+    }
+    bool none() const noexcept { return !any(); }
+    bool all() const noexcept { return count() == size_; }
+
+    // Posição do primeiro bit ligado (a partir de 'i', em '.find_next()'), ou
+    // 'npos'.
+    std::size_t find_first() const noexcept { return find_from(0); }
+    std::size_t find_next(std::size_t i) const noexcept {
+        return i + 1 >= size_ ? npos : find_from(i + 1);
+    }
+
+    set_bits_view set_bits() const noexcept { return set_bits_view{words_}; }
+
+    friend bool operator==(const dynamic_bitset&,
+                           const dynamic_bitset&) = default;
+
+   private:
+    // Zera os bits além de '.size()'.
+    void clear_tail() noexcept {
+        if (size_ % word_bits) {
+            words_.back() &= ~word_type{0} >> (word_bits - size_ % word_bits);
+        }
+    }
+
+    std::size_t find_from(std::size_t i) const noexcept {
+        auto w = i / word_bits;
+        if (w >= words_.size()) return npos;
+        auto bits = words_[w] & (~word_type{0} << (i % word_bits));
+        while (!bits) {
+            if (++w == words_.size()) return npos;
+            bits = words_[w];
+        }
+        return w * word_bits + static_cast<std::size_t>(std::countr_zero(bits));
+    }
+
+    // 'op' é aplicada tanto a vetores de 256 bits quanto a palavras.
+    template <typename Op>
+    dynamic_bitset& apply(const dynamic_bitset& o, Op op) {
+        if (o.size_ != size_) {
+            throw std::invalid_argument(
+                "dynamic_bitset: os conjuntos devem ter o mesmo tamanho.");
+        }
+        word_type* a = words_.data();
+        const word_type* b = o.words_.data();
+        std::size_t n = words_.size(), i = 0;
+#if defined(__AVX2__)
+        for (; i + 4 <= n; i += 4) {
+            auto va = _mm256_loadu_si256(reinterpret_cast<__m256i*>(a + i));
+            auto vb =
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(a + i), op(va, vb));
+        }
+#endif
+        for (; i < n; ++i) a[i] = op(a[i], b[i]);
+        return *this;
+    }
+
+    // Com AVX2, a contagem é feita por consulta a uma tabela com o número de
+    // bits de cada 'nibble' ('vpshufb'), somada byte a byte e acumulada com
+    // 'vpsadbw' (algoritmo de Muła, Kurz e Lemire).
+    static std::size_t popcount(const word_type* p, std::size_t n) noexcept {
+        std::size_t total = 0, i = 0;
+#if defined(__AVX2__)
+        const auto table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3,
+                                            2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3,
+                                            1, 2, 2, 3, 2, 3, 3, 4);
+        const auto low_mask = _mm256_set1_epi8(0x0F);
+        auto acc = _mm256_setzero_si256();
+        for (; i + 4 <= n; i += 4) {
+            auto v =
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+            auto lo = _mm256_shuffle_epi8(table, _mm256_and_si256(v, low_mask));
+            auto hi = _mm256_shuffle_epi8(
+                table, _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask));
+            acc = _mm256_add_epi64(
+                acc, _mm256_sad_epu8(_mm256_add_epi8(lo, hi),
+                                     _mm256_setzero_si256()));
+        }
+        alignas(32) std::uint64_t lanes[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+        total = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+        for (; i < n; ++i) {
+            total += static_cast<std::size_t>(std::popcount(p[i]));
+        }
+        return total;
+    }
+
+    std::vector<word_type> words_;
+    std::size_t size_{0};
+};
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Recuperação de memória baseada em épocas ('epoch-based reclamation').
+//
+// Estruturas 'lock-free' que armazenam ponteiros para objetos ('Widget',
+// 'Widget2', ...) precisam garantir que um objeto removido só seja destruído
+// quando nenhuma 'thread' leitora ainda puder estar acessando-o. Usar
+// 'std::shared_ptr' para isso implica incrementar e decrementar um contador
+// atômico compartilhado a cada leitura.
+//
+// Com 'epoch_domain', o leitor apenas abre um 'guard' (que publica a época
+// global observada pela sua 'thread') e acessa os ponteiros crus. Objetos
+// removidos são passados para '.retire()' e ficam numa lista local da
+// 'thread' que os removeu, marcados com a época da remoção. Periodicamente
+// tenta-se avançar a época global, o que só é possível quando todas as
+// 'threads' dentro de um 'guard' já observaram a época atual. Um objeto
+// retirado na época 'e' pode ser destruído quando a época global atingir
+// 'e + 2', pois nenhum leitor ativo pode ter começado antes da sua remoção.
+//
+// O domínio deve ser destruído apenas quando nenhuma 'thread' estiver dentro
+// de um 'guard' ou chamando '.retire()'.
+class epoch_domain {
+    static constexpr std::uint64_t inactive =
+        std::numeric_limits<std::uint64_t>::max();
+
+    struct retired {
+        void* obj;
+        void (*destroy)(void*);
+        std::uint64_t epoch;
+    };
+
+    // Estado de uma 'thread' participante, em linha de cache própria para que
+    // a publicação da época local não gere 'false sharing' entre leitores.
+    struct alignas(64) record {
+        std::atomic<bool> in_use{false};
+        std::atomic<std::uint64_t> local{inactive};
+        unsigned nesting{0};
+        std::vector<retired> retired_list;
+    };
+
+   public:
+    static constexpr std::size_t max_threads = 128;
+
+    explicit epoch_domain(std::size_t collect_threshold = 64)
+        : collect_threshold{collect_threshold}, id{next_id()} {
+        std::scoped_lock lock{registry_mutex()};
+        live_domains()[id] = this;
+    }
+
+    epoch_domain(const epoch_domain&) = delete;
+    epoch_domain& operator=(const epoch_domain&) = delete;
+
+    ~epoch_domain() {
+        {
+            std::scoped_lock lock{registry_mutex()};
+            live_domains().erase(id);
+        }
+        for (auto& r : records) destroy_all(r.retired_list);
+        destroy_all(orphans);
+    }
+
+    // Escopo de leitura. Enquanto existir, nenhum objeto retirado após a sua
+    // abertura será destruído. 'guards' podem ser aninhados.
+    class guard {
+       public:
+        explicit guard(epoch_domain& d) : r{d.local_record()} {
+            if (r.nesting++ == 0) {
+                r.local.store(d.global.load(std::memory_order_relaxed),
+                              std::memory_order_relaxed);
+                // A publicação da época local precisa ser visível antes de
+                // qualquer leitura de ponteiro realizada dentro do 'guard'.
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+            }
+        }
+        ~guard() {
+            if (--r.nesting == 0) {
+                r.local.store(inactive, std::memory_order_release);
+            }
+        }
+        guard(const guard&) = delete;
+        guard& operator=(const guard&) = delete;
+
+       private:
+        record& r;
+    };
+
+    // Agenda a destruição de 'p', que já deve estar inacessível para novos
+    // leitores (eg, removido da estrutura 'lock-free').
+    template <typename T>
+    void retire(T* p) {
+        record& r = local_record();
+        auto destroy = [](void* obj) { delete static_cast<T*>(obj); };
+        r.retired_list.push_back(
+            {p, destroy, global.load(std::memory_order_acquire)});
+        if (r.retired_list.size() >= collect_threshold) collect(r);
+    }
+
+    // Tenta avançar a época e destrói os objetos da 'thread' atual que já
+    // podem ser liberados.
+    void collect() { collect(local_record()); }
+
+    std::uint64_t epoch() const {
+        return global.load(std::memory_order_relaxed);
+    }
+
+   private:
+    bool try_advance() {
+        std::uint64_t e = global.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        for (auto& r : records) {
+            if (!r.in_use.load(std::memory_order_acquire)) continue;
+            auto l = r.local.load(std::memory_order_acquire);
+            if (l != inactive && l != e) return false;
+        }
+        return global.compare_exchange_strong(e, e + 1,
+                                              std::memory_order_acq_rel);
+    }
+
+    void collect(record& r) {
+        try_advance();
+        auto safe = global.load(std::memory_order_acquire);
+        std::erase_if(r.retired_list, [safe](const retired& x) {
+            if (x.epoch + 2 > safe) return false;
+            x.destroy(x.obj);
+            return true;
+        });
+        // Objetos deixados por 'threads' já encerradas.
+        if (!orphans_empty.load(std::memory_order_relaxed)) {
+            std::scoped_lock lock{orphans_mutex};
+            std::erase_if(orphans, [safe](const retired& x) {
+                if (x.epoch + 2 > safe) return false;
+                x.destroy(x.obj);
+                return true;
+            });
+            orphans_empty.store(orphans.empty(), std::memory_order_relaxed);
+        }
+    }
+
+    static void destroy_all(std::vector<retired>& list) {
+        for (auto& x : list) x.destroy(x.obj);
+        list.clear();
+    }
+
+    // Associação 'thread' -> 'record'. O 'cache' é indexado pelo 'id' do
+    // domínio (nunca reutilizado), de forma que entradas de domínios já
+    // destruídos jamais sejam acessadas. Ao término da 'thread', os 'records'
+    // de domínios ainda vivos são liberados e os objetos pendentes são
+    // repassados para a lista de órfãos do domínio.
+    struct thread_cache {
+        std::vector<std::pair<std::uint64_t, record*>> entries;
+        ~thread_cache() {
+            std::scoped_lock lock{registry_mutex()};
+            for (auto [domain_id, r] : entries) {
+                auto it = live_domains().find(domain_id);
+                if (it != live_domains().end()) it->second->release(*r);
+            }
+        }
+    };
+
+    record& local_record() {
+        thread_local thread_cache cache;
+        for (auto [domain_id, r] : cache.entries) {
+            if (domain_id == id) return *r;
+        }
+        for (auto& r : records) {
+            bool expected = false;
+            if (r.in_use.compare_exchange_strong(expected, true,
+                                                 std::memory_order_acq_rel)) {
+                cache.entries.emplace_back(id, &r);
+                return r;
+            }
+        }
+        throw std::runtime_error(
+            "epoch_domain: número máximo de 'threads' excedido.");
+    }
+
+    void release(record& r) {
+        {
+            std::scoped_lock lock{orphans_mutex};
+            orphans.insert(orphans.end(), r.retired_list.begin(),
+                           r.retired_list.end());
+            orphans_empty.store(orphans.empty(), std::memory_order_relaxed);
+        }
+        r.retired_list.clear();
+        r.local.store(inactive, std::memory_order_release);
+        r.in_use.store(false, std::memory_order_release);
+    }
+
+    static std::uint64_t next_id() {
+        static std::atomic<std::uint64_t> counter{0};
+        return counter.fetch_add(1, std::memory_order_relaxed);
+    }
+    static std::mutex& registry_mutex() {
+        static std::mutex m;
+        return m;
+    }
+    static std::unordered_map<std::uint64_t, epoch_domain*>& live_domains() {
+        static std::unordered_map<std::uint64_t, epoch_domain*> m;
+        return m;
+    }
+
+    const std::size_t collect_threshold;
+    const std::uint64_t id;
+    std::atomic<std::uint64_t> global{0};
+    std::array<record, max_threads> records;
+    std::mutex orphans_mutex;
+    std::vector<retired> orphans;
+    std::atomic<bool> orphans_empty{true};
+};
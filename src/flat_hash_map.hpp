@@ -0,0 +1,507 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "trivially_relocatable.hpp"
+
+// Funções de 'hash' para 'flat_hash_map'. Os 7 bits mais altos do 'hash' são
+// guardados nos bytes de controle e os mais baixos escolhem a posição
+// inicial, portanto todos os bits precisam ser bem distribuídos: não é o
+// caso de 'std::hash<int>' (a identidade, na 'libstdc++').
+namespace flat_hashing {
+
+inline std::uint64_t mix(std::uint64_t a, std::uint64_t b) {
+    auto r = static_cast<unsigned __int128>(a) * b;
+    return static_cast<std::uint64_t>(r) ^ static_cast<std::uint64_t>(r >> 64);
+}
+
+inline constexpr std::uint64_t k0 = 0x9E3779B97F4A7C15;
+inline constexpr std::uint64_t k1 = 0xA0761D6478BD642F;
+inline constexpr std::uint64_t k2 = 0xE7037ED1A0B428DB;
+
+inline std::uint64_t load64(const char* p) {
+    std::uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+inline std::uint64_t load32(const char* p) {
+    std::uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// 'Hash' de 'strings' no estilo de 'wyhash': 16 bytes por multiplicação de
+// 128 bits, e os bytes finais lidos com cargas sobrepostas (sem laço byte a
+// byte).
+inline std::uint64_t hash_bytes(std::string_view s) {
+    const char* p = s.data();
+    std::size_t n = s.size();
+    std::uint64_t seed = k0 ^ n;
+    std::uint64_t a = 0, b = 0;
+    if (n <= 16) {
+        if (n >= 8) {
+            a = load64(p);
+            b = load64(p + n - 8);
+        } else if (n >= 4) {
+            a = load32(p);
+            b = load32(p + n - 4);
+        } else if (n > 0) {
+            a = (std::uint64_t{static_cast<unsigned char>(p[0])} << 16) |
+                (std::uint64_t{static_cast<unsigned char>(p[n / 2])} << 8) |
+                static_cast<unsigned char>(p[n - 1]);
+        }
+    } else {
+        for (; n > 16; n -= 16, p += 16) {
+            seed = mix(load64(p) ^ k1, load64(p + 8) ^ seed);
+        }
+        a = load64(p + n - 16);
+        b = load64(p + n - 8);
+    }
+    return mix(k1 ^ s.size(), mix(a ^ k1, b ^ seed));
+}
+
+}  // namespace flat_hashing
+
+template <typename Key>
+struct flat_hash {
+    std::uint64_t operator()(const Key& key) const {
+        return flat_hashing::mix(std::hash<Key>{}(key) ^ flat_hashing::k2,
+                                 flat_hashing::k0);
+    }
+};
+
+// 'Strings' são todas tratadas como 'std::string_view': com 'std::equal_to<>'
+// a busca com 'std::string_view' ou 'const char*' não constrói uma
+// 'std::string' temporária.
+struct flat_string_hash {
+    using is_transparent = void;
+    std::uint64_t operator()(std::string_view s) const {
+        return flat_hashing::hash_bytes(s);
+    }
+};
+template <>
+struct flat_hash<std::string> : flat_string_hash {};
+template <>
+struct flat_hash<std::string_view> : flat_string_hash {};
+
+// Tabela 'hash' de endereçamento aberto no estilo da 'SwissTable' (Abseil).
+//
+// 'std::unordered_map' (item_5 e item_9) aloca um nó por elemento e encadeia
+// os nós de cada 'bucket' por ponteiros. Aqui, os elementos ficam num único
+// arranjo, e um arranjo paralelo de bytes de controle guarda, para cada
+// posição, se está vazia ou, caso ocupada, 7 bits do 'hash' da chave. Uma
+// busca compara 16 bytes de controle de uma só vez (SSE2) com os 7 bits da
+// chave procurada, e apenas as posições coincidentes têm as chaves comparadas.
+//
+// - A sondagem é linear (de 16 em 16 posições), e não quadrática como na
+//   'SwissTable'. Assim, a remoção desloca para trás os elementos seguintes
+//   do mesmo agrupamento ('backward shift deletion'), sem deixar marcadores
+//   de posição removida ('tombstones'), que degradam as buscas e exigiriam
+//   reconstruções periódicas da tabela. Em contrapartida, a remoção recalcula
+//   o 'hash' dos elementos deslocados.
+// - Com 'Hash' e 'Equal' transparentes (o padrão para chaves 'std::string'),
+//   as buscas aceitam 'std::string_view' e 'const char*'.
+// - Ocupação máxima de 7/8; a capacidade é sempre uma potência de 2.
+//
+// Qualquer inserção pode invalidar iteradores e referências (a tabela é
+// realocada ao crescer), assim como a remoção. Como em 'flat_map'
+// (./flat_map.hpp), os iteradores retornam pares de referências
+// ('std::pair<const Key&, T&>').
+template <typename Key, typename T, typename Hash = flat_hash<Key>,
+          typename Equal = std::equal_to<>>
+class flat_hash_map {
+    static_assert(std::is_nothrow_move_constructible_v<Key> &&
+                      std::is_nothrow_move_constructible_v<T>,
+                  "'flat_hash_map' exige elementos 'nothrow move "
+                  "constructible'.");
+
+    static constexpr std::size_t group_width = 16;
+    static constexpr std::size_t min_capacity = 16;
+    static constexpr std::int8_t empty_ctrl = -128;  // 0b10000000.
+
+    template <typename K>
+    static constexpr bool lookup_key =
+        std::is_convertible_v<const K&, const Key&> ||
+        (requires {
+            typename Hash::is_transparent;
+            typename Equal::is_transparent;
+        } && std::is_invocable_v<const Hash&, const K&>);
+
+    struct slot {
+        Key key;
+        T value;
+    };
+
+    // Máscara de bits dos bytes de controle de 'ctrl[0, 16)' iguais a 'tag'
+    // (o bit 'i' corresponde a 'ctrl[i]').
+    static std::uint32_t match(const std::int8_t* ctrl, std::int8_t tag) {
+#if defined(__SSE2__)
+        auto group =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+        return static_cast<std::uint32_t>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(tag))));
+#else
+        std::uint32_t mask = 0;
+        for (std::size_t i = 0; i < group_width; ++i) {
+            mask |= std::uint32_t{ctrl[i] == tag} << i;
+        }
+        return mask;
+#endif
+    }
+
+    template <bool Const>
+    class basic_iterator {
+        using table_ptr =
+            std::conditional_t<Const, const flat_hash_map*, flat_hash_map*>;
+        using mapped_ref = std::conditional_t<Const, const T&, T&>;
+
+       public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::pair<Key, T>;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::pair<const Key&, mapped_ref>;
+
+        // 'operator->' de um iterador cuja referência não é um 'lvalue'.
+        struct pointer {
+            reference ref;
+            const reference* operator->() const { return &ref; }
+        };
+
+        basic_iterator() = default;
+        basic_iterator(const basic_iterator&) = default;
+        basic_iterator& operator=(const basic_iterator&) = default;
+        // 'iterator' -> 'const_iterator'.
+        basic_iterator(const basic_iterator<false>& o)
+            requires Const
+            : t{o.t}, i{o.i} {}
+
+        reference operator*() const {
+            auto& s = t->slots[i];
+            return {s.key, s.value};
+        }
+        pointer operator->() const { return {**this}; }
+
+        basic_iterator& operator++() {
+            i = t->next_full(i + 1);
+            return *this;
+        }
+        basic_iterator operator++(int) {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const basic_iterator& o) const { return i == o.i; }
+
+       private:
+        friend class flat_hash_map;
+        basic_iterator(table_ptr t, std::size_t i) : t{t}, i{i} {}
+
+        table_ptr t{nullptr};
+        std::size_t i{0};
+    };
+
+   public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<Key, T>;
+    using size_type = std::size_t;
+    using hasher = Hash;
+    using key_equal = Equal;
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    // Construtores:
+    flat_hash_map() = default;
+    explicit flat_hash_map(size_type n) { reserve(n); }
+    flat_hash_map(std::initializer_list<value_type> il) {
+        reserve(il.size());
+        for (const auto& v : il) insert(v);
+    }
+    flat_hash_map(const flat_hash_map& o) : hash{o.hash}, equal{o.equal} {
+        reserve(o.size());
+        for (auto [k, v] : o) try_emplace(k, v);
+    }
+    flat_hash_map(flat_hash_map&& o) noexcept { swap(o); }
+    flat_hash_map& operator=(flat_hash_map o) noexcept {
+        swap(o);
+        return *this;
+    }
+    ~flat_hash_map() {
+        clear();
+        release();
+    }
+
+    void swap(flat_hash_map& o) noexcept {
+        using std::swap;
+        swap(ctrl, o.ctrl);
+        swap(slots, o.slots);
+        swap(capacity_, o.capacity_);
+        swap(size_, o.size_);
+        swap(hash, o.hash);
+        swap(equal, o.equal);
+    }
+    friend void swap(flat_hash_map& a, flat_hash_map& b) noexcept {
+        a.swap(b);
+    }
+
+    // Acesso aos elementos:
+    template <typename K>
+        requires lookup_key<K>
+    T& at(const K& key) {
+        auto i = find_index(key);
+        if (i == capacity_) throw std::out_of_range("flat_hash_map::at");
+        return slots[i].value;
+    }
+    template <typename K>
+        requires lookup_key<K>
+    const T& at(const K& key) const {
+        auto i = find_index(key);
+        if (i == capacity_) throw std::out_of_range("flat_hash_map::at");
+        return slots[i].value;
+    }
+    T& operator[](const Key& key) { return try_emplace(key).first->second; }
+    T& operator[](Key&& key) {
+        return try_emplace(std::move(key)).first->second;
+    }
+
+    // Iteradores:
+    iterator begin() noexcept { return {this, next_full(0)}; }
+    iterator end() noexcept { return {this, capacity_}; }
+    const_iterator begin() const noexcept { return {this, next_full(0)}; }
+    const_iterator end() const noexcept { return {this, capacity_}; }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    // Capacidade:
+    size_type size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+    size_type capacity() const noexcept { return capacity_; }
+    void reserve(size_type n) {
+        auto needed = std::bit_ceil(std::max(min_capacity, n + n / 7 + 1));
+        if (needed > capacity_) rehash(needed);
+    }
+
+    // Modificadores:
+    void clear() noexcept {
+        for (std::size_t i = 0; i < capacity_; ++i) {
+            if (ctrl[i] >= 0) std::destroy_at(&slots[i]);
+        }
+        if (ctrl) std::memset(ctrl, empty_ctrl, capacity_ + group_width - 1);
+        size_ = 0;
+    }
+
+    template <typename K, typename... Args>
+        requires std::is_constructible_v<Key, K&&>
+    std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+        auto h = hash(static_cast<const K&>(key));
+        // Sem 'rehash', a posição vazia encontrada pela busca é a da inserção.
+        std::size_t i = 0;
+        if (capacity_) {
+            auto [pos, found] = probe(key, h);
+            if (found) return {iterator{this, pos}, false};
+            i = pos;
+        }
+        if ((size_ + 1) * 8 > capacity_ * 7) {
+            // 'key' e 'args' podem referenciar um elemento do próprio mapa,
+            // que deixaria de ser válido após o 'rehash':
+            slot tmp{Key(std::forward<K>(key)), T(std::forward<Args>(args)...)};
+            rehash(std::max(min_capacity, capacity_ * 2));
+            i = probe(tmp.key, h).first;
+            ::new (static_cast<void*>(&slots[i])) slot{std::move(tmp)};
+        } else {
+            ::new (static_cast<void*>(&slots[i])) slot{
+                Key(std::forward<K>(key)), T(std::forward<Args>(args)...)};
+        }
+        set_ctrl(i, tag(h));
+        ++size_;
+        return {iterator{this, i}, true};
+    }
+    std::pair<iterator, bool> insert(const value_type& v) {
+        return try_emplace(v.first, v.second);
+    }
+    std::pair<iterator, bool> insert(value_type&& v) {
+        return try_emplace(std::move(v.first), std::move(v.second));
+    }
+
+    template <typename K>
+        requires(lookup_key<K> && !std::is_convertible_v<K, const_iterator>)
+    size_type erase(const K& key) {
+        auto i = find_index(key);
+        if (i == capacity_) return 0;
+        erase_index(i);
+        return 1;
+    }
+    // Como os elementos seguintes podem ser deslocados para a posição
+    // removida, não há iterador válido para o "próximo" elemento.
+    void erase(const_iterator pos) { erase_index(pos.i); }
+
+    // Busca:
+    template <typename K>
+        requires lookup_key<K>
+    iterator find(const K& key) {
+        return {this, find_index(key)};
+    }
+    template <typename K>
+        requires lookup_key<K>
+    const_iterator find(const K& key) const {
+        return {this, find_index(key)};
+    }
+    template <typename K>
+        requires lookup_key<K>
+    bool contains(const K& key) const {
+        return find_index(key) != capacity_;
+    }
+    template <typename K>
+        requires lookup_key<K>
+    size_type count(const K& key) const {
+        return contains(key) ? 1 : 0;
+    }
+
+   private:
+    // 7 bits mais altos do 'hash' (valor não negativo: posição ocupada).
+    static std::int8_t tag(std::uint64_t h) {
+        return static_cast<std::int8_t>(h >> 57);
+    }
+
+    void set_ctrl(std::size_t i, std::int8_t v) {
+        ctrl[i] = v;
+        // Os primeiros bytes são replicados após o fim, para que a leitura de
+        // 16 bytes a partir de qualquer posição não precise dar a volta.
+        if (i < group_width - 1) ctrl[capacity_ + i] = v;
+    }
+
+    // Posição de 'key' ('true') ou a primeira posição vazia da sua sequência
+    // de sondagem ('false'). Exige 'capacity_ > 0'.
+    template <typename K>
+    std::pair<std::size_t, bool> probe(const K& key, std::uint64_t h) const {
+        auto mask = capacity_ - 1;
+        auto t = tag(h);
+        for (auto pos = static_cast<std::size_t>(h) & mask;;
+             pos = (pos + group_width) & mask) {
+            for (auto m = match(ctrl + pos, t); m; m &= m - 1) {
+                auto i = (pos + std::countr_zero(m)) & mask;
+                if (equal(slots[i].key, key)) return {i, true};
+            }
+            if (auto e = match(ctrl + pos, empty_ctrl)) {
+                return {(pos + std::countr_zero(e)) & mask, false};
+            }
+        }
+    }
+
+    // Posição de 'key', ou 'capacity_' caso não esteja presente.
+    template <typename K>
+    std::size_t find_index(const K& key) const {
+        if (size_ == 0) return capacity_;
+        auto [i, found] = probe(key, hash(key));
+        return found ? i : capacity_;
+    }
+
+    std::size_t next_full(std::size_t i) const {
+        while (i < capacity_ && ctrl[i] < 0) ++i;
+        return i;
+    }
+
+    // Transfere o elemento de 'from' para a posição vazia 'to'.
+    static void relocate(slot* from, slot* to) noexcept {
+        if constexpr (is_trivially_relocatable_v<Key> &&
+                      is_trivially_relocatable_v<T>) {
+            std::memcpy(static_cast<void*>(to), from, sizeof(slot));
+        } else {
+            ::new (static_cast<void*>(to))
+                slot{std::move(from->key), std::move(from->value)};
+            std::destroy_at(from);
+        }
+    }
+
+    // Remoção sem 'tombstones' (algoritmo R de Knuth): os elementos seguintes
+    // do agrupamento que não estejam na sua posição inicial são deslocados
+    // para a posição vaga, desde que isso não os coloque antes da posição
+    // inicial deles.
+    void erase_index(std::size_t i) noexcept {
+        auto mask = capacity_ - 1;
+        std::destroy_at(&slots[i]);
+        for (auto j = (i + 1) & mask; ctrl[j] != empty_ctrl;
+             j = (j + 1) & mask) {
+            auto home = static_cast<std::size_t>(hash(slots[j].key)) & mask;
+            // 'home' está no intervalo circular '(i, j]': o elemento não
+            // pode ser movido para 'i'.
+            bool stays = i <= j ? (i < home && home <= j)
+                                : (i < home || home <= j);
+            if (stays) continue;
+            relocate(&slots[j], &slots[i]);
+            set_ctrl(i, ctrl[j]);
+            i = j;
+        }
+        set_ctrl(i, empty_ctrl);
+        --size_;
+    }
+
+    void rehash(std::size_t n) {
+        flat_hash_map next;
+        next.hash = hash;
+        next.equal = equal;
+        next.allocate(n);
+        auto mask = n - 1;
+        for (std::size_t i = 0; i < capacity_; ++i) {
+            if (ctrl[i] < 0) continue;
+            auto h = hash(slots[i].key);
+            auto pos = static_cast<std::size_t>(h) & mask;
+            std::uint32_t e;
+            while (!(e = match(next.ctrl + pos, empty_ctrl))) {
+                pos = (pos + group_width) & mask;
+            }
+            auto j = (pos + std::countr_zero(e)) & mask;
+            relocate(&slots[i], &next.slots[j]);
+            next.set_ctrl(j, ctrl[i]);
+        }
+        next.size_ = size_;
+        // Os elementos foram transferidos: apenas a memória é liberada.
+        release();
+        swap(next);
+    }
+
+    void allocate(std::size_t n) {
+        slots = std::allocator<slot>{}.allocate(n);
+        try {
+            ctrl = std::allocator<std::int8_t>{}.allocate(n + group_width - 1);
+        } catch (...) {
+            std::allocator<slot>{}.deallocate(slots, n);
+            slots = nullptr;
+            throw;
+        }
+        capacity_ = n;
+        std::memset(ctrl, empty_ctrl, n + group_width - 1);
+    }
+    void release() noexcept {
+        if (!ctrl) return;
+        std::allocator<slot>{}.deallocate(slots, capacity_);
+        std::allocator<std::int8_t>{}.deallocate(ctrl,
+                                                 capacity_ + group_width - 1);
+        ctrl = nullptr;
+        slots = nullptr;
+        capacity_ = 0;
+        size_ = 0;
+    }
+
+    std::int8_t* ctrl{nullptr};  // 'capacity_ + 15' bytes.
+    slot* slots{nullptr};
+    std::size_t capacity_{0};
+    std::size_t size_{0};
+    [[no_unique_address]] Hash hash{};
+    [[no_unique_address]] Equal equal{};
+};
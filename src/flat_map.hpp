@@ -0,0 +1,346 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <ranges>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Mapa ordenado sobre arranjos contíguos, no estilo de 'std::flat_map'
+// (C++23).
+//
+// 'std::map' (como 'Bar1::values' e 'Bar2::values' do item_17) aloca um nó
+// por elemento, e cada busca percorre uma árvore de ponteiros espalhados pela
+// memória. 'flat_map' guarda as chaves, ordenadas, num 'std::vector', e os
+// valores correspondentes num segundo 'std::vector' ('structure of arrays'):
+// a busca percorre apenas o arranjo compacto de chaves.
+//
+// - '.insert_range()' acrescenta muitos elementos de uma só vez: os novos
+//   elementos são ordenados e intercalados com os existentes numa única
+//   passada (O(n + m log m)), ao invés de uma inserção O(n) por elemento.
+// - A busca binária ('lower_bound') não possui desvios condicionais
+//   dependentes dos dados (o compilador emprega 'cmov'), evitando as
+//   previsões de desvio erradas de 'std::lower_bound'.
+// - Com um comparador transparente (eg, 'std::less<>'), as buscas aceitam
+//   qualquer tipo comparável com a chave (eg, 'std::string_view' para chaves
+//   'std::string').
+//
+// Inserções e remoções individuais custam O(n), e invalidam os iteradores.
+// Como em 'std::flat_map', os iteradores retornam pares de referências
+// ('std::pair<const Key&, T&>') e não referências para pares.
+template <typename Key, typename T, typename Compare = std::less<Key>>
+class flat_map {
+    static constexpr bool transparent_compare =
+        requires { typename Compare::is_transparent; };
+    // Tipos aceitos nas buscas. Com um comparador não transparente, 'K' é
+    // convertido para 'Key' uma única vez, antes da busca ('converts<K>').
+    template <typename K>
+    static constexpr bool transparent =
+        transparent_compare || std::is_convertible_v<const K&, const Key&>;
+    template <typename K>
+    static constexpr bool converts =
+        !transparent_compare && !std::is_same_v<std::remove_cvref_t<K>, Key>;
+
+    template <bool Const>
+    class basic_iterator {
+        using map_ptr = std::conditional_t<Const, const flat_map*, flat_map*>;
+        using mapped_ref = std::conditional_t<Const, const T&, T&>;
+
+       public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::pair<Key, T>;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::pair<const Key&, mapped_ref>;
+
+        // 'operator->' de um iterador cuja referência não é um 'lvalue'.
+        struct pointer {
+            reference ref;
+            const reference* operator->() const { return &ref; }
+        };
+
+        basic_iterator() = default;
+        basic_iterator(const basic_iterator&) = default;
+        basic_iterator& operator=(const basic_iterator&) = default;
+        // 'iterator' -> 'const_iterator'.
+        basic_iterator(const basic_iterator<false>& o)
+            requires Const
+            : m{o.m}, i{o.i} {}
+
+        reference operator*() const { return {m->keys_[i], m->values_[i]}; }
+        pointer operator->() const { return {**this}; }
+        reference operator[](difference_type n) const { return *(*this + n); }
+
+        basic_iterator& operator++() {
+            ++i;
+            return *this;
+        }
+        basic_iterator operator++(int) {
+            auto tmp = *this;
+            ++i;
+            return tmp;
+        }
+        basic_iterator& operator--() {
+            --i;
+            return *this;
+        }
+        basic_iterator operator--(int) {
+            auto tmp = *this;
+            --i;
+            return tmp;
+        }
+        basic_iterator& operator+=(difference_type n) {
+            i += static_cast<std::size_t>(n);
+            return *this;
+        }
+        basic_iterator& operator-=(difference_type n) {
+            i -= static_cast<std::size_t>(n);
+            return *this;
+        }
+        friend basic_iterator operator+(basic_iterator it, difference_type n) {
+            return it += n;
+        }
+        friend basic_iterator operator+(difference_type n, basic_iterator it) {
+            return it += n;
+        }
+        friend basic_iterator operator-(basic_iterator it, difference_type n) {
+            return it -= n;
+        }
+        friend difference_type operator-(const basic_iterator& a,
+                                         const basic_iterator& b) {
+            return static_cast<difference_type>(a.i) -
+                   static_cast<difference_type>(b.i);
+        }
+
+        bool operator==(const basic_iterator& o) const { return i == o.i; }
+        auto operator<=>(const basic_iterator& o) const { return i <=> o.i; }
+
+       private:
+        friend class flat_map;
+        basic_iterator(map_ptr m, std::size_t i) : m{m}, i{i} {}
+
+        map_ptr m{nullptr};
+        std::size_t i{0};
+    };
+
+   public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<Key, T>;
+    using key_compare = Compare;
+    using size_type = std::size_t;
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    // Construtores:
+    flat_map() = default;
+    explicit flat_map(const Compare& comp) : comp{comp} {}
+    flat_map(std::initializer_list<value_type> il,
+             const Compare& comp = Compare())
+        : comp{comp} {
+        insert_range(il);
+    }
+
+    // Acesso aos elementos:
+    T& operator[](const Key& key) { return try_emplace(key).first->second; }
+    T& operator[](Key&& key) {
+        return try_emplace(std::move(key)).first->second;
+    }
+    template <typename K>
+        requires transparent<K>
+    T& at(const K& key) {
+        auto i = index_of(key);
+        if (i == keys_.size()) throw std::out_of_range("flat_map::at");
+        return values_[i];
+    }
+    template <typename K>
+        requires transparent<K>
+    const T& at(const K& key) const {
+        auto i = index_of(key);
+        if (i == keys_.size()) throw std::out_of_range("flat_map::at");
+        return values_[i];
+    }
+
+    // Os arranjos ordenados de chaves e de valores.
+    const std::vector<Key>& keys() const noexcept { return keys_; }
+    const std::vector<T>& values() const noexcept { return values_; }
+
+    // Iteradores:
+    iterator begin() noexcept { return {this, 0}; }
+    iterator end() noexcept { return {this, keys_.size()}; }
+    const_iterator begin() const noexcept { return {this, 0}; }
+    const_iterator end() const noexcept { return {this, keys_.size()}; }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    // Capacidade:
+    size_type size() const noexcept { return keys_.size(); }
+    bool empty() const noexcept { return keys_.empty(); }
+    void reserve(size_type n) {
+        keys_.reserve(n);
+        values_.reserve(n);
+    }
+
+    // Modificadores:
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+        if constexpr (converts<K>) {
+            return try_emplace(Key(std::forward<K>(key)),
+                               std::forward<Args>(args)...);
+        }
+        auto i = lower_bound_index(key);
+        if (i < keys_.size() && !comp(key, keys_[i])) {
+            return {iterator{this, i}, false};
+        }
+        auto offset = static_cast<std::ptrdiff_t>(i);
+        keys_.insert(keys_.begin() + offset, Key(std::forward<K>(key)));
+        try {
+            values_.emplace(values_.begin() + offset,
+                            std::forward<Args>(args)...);
+        } catch (...) {
+            keys_.erase(keys_.begin() + offset);
+            throw;
+        }
+        return {iterator{this, i}, true};
+    }
+    std::pair<iterator, bool> insert(const value_type& v) {
+        return try_emplace(v.first, v.second);
+    }
+    std::pair<iterator, bool> insert(value_type&& v) {
+        return try_emplace(std::move(v.first), std::move(v.second));
+    }
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        return insert(value_type(std::forward<Args>(args)...));
+    }
+
+    // Insere todos os pares de 'range'. Assim como em '.insert()', chaves já
+    // presentes (ou repetidas em 'range') mantêm o primeiro valor.
+    template <std::ranges::input_range R>
+    void insert_range(R&& range) {
+        std::vector<value_type> added;
+        if constexpr (std::ranges::sized_range<R>) {
+            added.reserve(std::ranges::size(range));
+        }
+        for (auto&& v : range) added.emplace_back(std::forward<decltype(v)>(v));
+        auto less = [&](const value_type& a, const value_type& b) {
+            return comp(a.first, b.first);
+        };
+        std::ranges::stable_sort(added, less);
+
+        // Intercalação dos elementos existentes com os novos.
+        std::vector<Key> merged_keys;
+        std::vector<T> merged_values;
+        merged_keys.reserve(keys_.size() + added.size());
+        merged_values.reserve(keys_.size() + added.size());
+        auto push = [&](auto&& key, auto&& value) {
+            if (!merged_keys.empty() && !comp(merged_keys.back(), key)) return;
+            merged_keys.push_back(std::forward<decltype(key)>(key));
+            merged_values.push_back(std::forward<decltype(value)>(value));
+        };
+        std::size_t i = 0;
+        auto a = added.begin();
+        while (i < keys_.size() || a != added.end()) {
+            if (a == added.end() ||
+                (i < keys_.size() && !comp(a->first, keys_[i]))) {
+                push(std::move(keys_[i]), std::move(values_[i]));
+                ++i;
+            } else {
+                push(std::move(a->first), std::move(a->second));
+                ++a;
+            }
+        }
+        keys_ = std::move(merged_keys);
+        values_ = std::move(merged_values);
+    }
+
+    template <typename K>
+        requires(transparent<K> && !std::is_convertible_v<K, const_iterator>)
+    size_type erase(const K& key) {
+        auto i = index_of(key);
+        if (i == keys_.size()) return 0;
+        erase(iterator{this, i});
+        return 1;
+    }
+    iterator erase(const_iterator pos) {
+        auto offset = static_cast<std::ptrdiff_t>(pos.i);
+        keys_.erase(keys_.begin() + offset);
+        values_.erase(values_.begin() + offset);
+        return {this, pos.i};
+    }
+
+    void clear() noexcept {
+        keys_.clear();
+        values_.clear();
+    }
+
+    // Busca:
+    template <typename K>
+        requires transparent<K>
+    iterator find(const K& key) {
+        return {this, index_of(key)};
+    }
+    template <typename K>
+        requires transparent<K>
+    const_iterator find(const K& key) const {
+        return {this, index_of(key)};
+    }
+    template <typename K>
+        requires transparent<K>
+    bool contains(const K& key) const {
+        return index_of(key) != keys_.size();
+    }
+    template <typename K>
+        requires transparent<K>
+    size_type count(const K& key) const {
+        return contains(key) ? 1 : 0;
+    }
+    template <typename K>
+        requires transparent<K>
+    iterator lower_bound(const K& key) {
+        return {this, lower_bound_index(key)};
+    }
+    template <typename K>
+        requires transparent<K>
+    const_iterator lower_bound(const K& key) const {
+        return {this, lower_bound_index(key)};
+    }
+
+    friend bool operator==(const flat_map& a, const flat_map& b) {
+        return a.keys_ == b.keys_ && a.values_ == b.values_;
+    }
+
+   private:
+    // Busca binária sem desvios: a cada passo, o intervalo de busca
+    // '[base, base + n]' é reduzido à metade por uma seleção condicional.
+    template <typename K>
+    size_type lower_bound_index(const K& key) const {
+        if constexpr (converts<K>) return lower_bound_index(Key(key));
+        const Key* base = keys_.data();
+        size_type n = keys_.size();
+        if (n == 0) return 0;
+        while (n > 1) {
+            size_type half = n / 2;
+            base = comp(base[half], key) ? base + half : base;
+            n -= half;
+        }
+        return static_cast<size_type>(base - keys_.data()) +
+               (comp(*base, key) ? 1 : 0);
+    }
+
+    // Posição de 'key', ou '.size()' caso não esteja presente.
+    template <typename K>
+    size_type index_of(const K& key) const {
+        if constexpr (converts<K>) return index_of(Key(key));
+        auto i = lower_bound_index(key);
+        return i < keys_.size() && !comp(key, keys_[i]) ? i : keys_.size();
+    }
+
+    std::vector<Key> keys_;
+    std::vector<T> values_;
+    [[no_unique_address]] Compare comp{};
+};
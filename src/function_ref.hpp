@@ -0,0 +1,74 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+// Referência não proprietária para um objeto invocável, no estilo de
+// 'std::function_ref' (C++26).
+//
+// Funções de ordem superior como 'g' (item_24), 'fwd' (item_30) e as
+// 'lambdas' invocadoras do item_33 são 'templates': cada tipo de função
+// passada gera uma nova instanciação. Numa interface que não seja 'template',
+// a alternativa usual é 'std::function', que pode alocar memória na 'heap' a
+// cada chamada (para capturas maiores que o seu 'buffer' interno) e realiza
+// uma indireção dupla na invocação.
+//
+// 'function_ref' armazena apenas dois ponteiros (o endereço do invocável e a
+// função que o invoca), é 'trivially copyable' e nunca aloca memória. Deve
+// ser passado por valor, e somente como parâmetro de funções que não guardem
+// a referência após retornarem: o invocável referenciado (eg, uma 'lambda'
+// temporária) não tem o seu tempo de vida estendido.
+template <typename Signature>
+class function_ref;
+
+template <typename R, typename... Args>
+class function_ref<R(Args...)> {
+    // Ponteiros para funções são guardados por valor, já que o próprio
+    // ponteiro costuma ser um temporário (eg, 'function_ref f = &g;').
+    union storage {
+        const void* object;
+        void (*function)();
+    };
+
+   public:
+    template <typename F>
+        requires(!std::is_same_v<std::remove_cvref_t<F>, function_ref> &&
+                 !std::is_pointer_v<std::decay_t<F>> &&
+                 !std::is_member_pointer_v<std::remove_cvref_t<F>> &&
+                 std::is_invocable_r_v<R, F&, Args...>)
+    function_ref(F&& f) noexcept
+        : thunk{[](storage s, Args&&... args) -> R {
+              using T = std::remove_reference_t<F>;
+              return std::invoke_r<R>(
+                  *static_cast<T*>(const_cast<void*>(s.object)),
+                  std::forward<Args>(args)...);
+          }} {
+        target.object = std::addressof(f);
+    }
+
+    // Funções (e ponteiros para funções), que não podem ser nulos.
+    template <typename F>
+        requires(std::is_function_v<std::remove_pointer_t<std::decay_t<F>>> &&
+                 std::is_invocable_r_v<R, F, Args...>)
+    function_ref(F&& f) noexcept
+        : thunk{[](storage s, Args&&... args) -> R {
+              return std::invoke_r<R>(
+                  reinterpret_cast<std::decay_t<F>>(s.function),
+                  std::forward<Args>(args)...);
+          }} {
+        target.function = reinterpret_cast<void (*)()>(std::decay_t<F>(f));
+    }
+
+    function_ref(const function_ref&) noexcept = default;
+    function_ref& operator=(const function_ref&) noexcept = default;
+
+    R operator()(Args... args) const {
+        return thunk(target, std::forward<Args>(args)...);
+    }
+
+   private:
+    storage target;
+    R (*thunk)(storage, Args&&...);
+};
@@ -0,0 +1,364 @@
+#pragma once
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "trivially_relocatable.hpp"
+
+// 'gap_buffer<T>': sequência com a interface de inserção e remoção por
+// iterador de 'std::vector<T>' ('.insert(pos, ...)', '.erase(pos)'),
+// otimizada para inserções agrupadas no meio da sequência, como num editor de
+// texto.
+//
+// 'vector::insert' (item_13) desloca todos os elementos posteriores a cada
+// inserção. Aqui, os elementos ocupam as duas extremidades de um único bloco
+// de memória, separadas por uma lacuna ('gap') de posições livres:
+//
+//   [ a b c d _ _ _ _ e f g ]
+//             ^ lacuna
+//
+// Inserir e remover na posição da lacuna custa O(1). Para operar noutra
+// posição, a lacuna é antes deslocada até ela, movendo apenas os elementos
+// entre as duas posições: inserções sucessivas próximas umas das outras são
+// baratas, enquanto inserções em posições aleatórias custam o mesmo que em
+// 'std::vector'.
+//
+// Os iteradores são de acesso aleatório e, como os de 'std::vector', são
+// invalidados por qualquer inserção ou remoção. 'T' deve ser 'nothrow move
+// constructible' (a lacuna é deslocada movendo elementos).
+template <typename T, typename Alloc = std::allocator<T>>
+class gap_buffer {
+    static_assert(std::is_nothrow_move_constructible_v<T>,
+                  "'gap_buffer' exige 'T' 'nothrow move constructible'.");
+    using traits = std::allocator_traits<Alloc>;
+
+    static constexpr std::size_t min_capacity = 16;
+
+    template <bool Const>
+    class basic_iterator {
+        using buffer_ptr =
+            std::conditional_t<Const, const gap_buffer*, gap_buffer*>;
+
+       public:
+        using iterator_concept = std::random_access_iterator_tag;
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const T*, T*>;
+        using reference = std::conditional_t<Const, const T&, T&>;
+
+        basic_iterator() = default;
+        basic_iterator(const basic_iterator&) = default;
+        basic_iterator& operator=(const basic_iterator&) = default;
+        // 'iterator' -> 'const_iterator'.
+        basic_iterator(const basic_iterator<false>& o)
+            requires Const
+            : buf{o.buf}, i{o.i} {}
+
+        reference operator*() const { return (*buf)[i]; }
+        pointer operator->() const { return &(*buf)[i]; }
+        reference operator[](difference_type n) const {
+            return (*buf)[i + static_cast<std::size_t>(n)];
+        }
+
+        basic_iterator& operator++() {
+            ++i;
+            return *this;
+        }
+        basic_iterator operator++(int) {
+            auto tmp = *this;
+            ++i;
+            return tmp;
+        }
+        basic_iterator& operator--() {
+            --i;
+            return *this;
+        }
+        basic_iterator operator--(int) {
+            auto tmp = *this;
+            --i;
+            return tmp;
+        }
+        basic_iterator& operator+=(difference_type n) {
+            i += static_cast<std::size_t>(n);
+            return *this;
+        }
+        basic_iterator& operator-=(difference_type n) {
+            i -= static_cast<std::size_t>(n);
+            return *this;
+        }
+        friend basic_iterator operator+(basic_iterator it, difference_type n) {
+            return it += n;
+        }
+        friend basic_iterator operator+(difference_type n, basic_iterator it) {
+            return it += n;
+        }
+        friend basic_iterator operator-(basic_iterator it, difference_type n) {
+            return it -= n;
+        }
+        friend difference_type operator-(const basic_iterator& a,
+                                         const basic_iterator& b) {
+            return static_cast<difference_type>(a.i) -
+                   static_cast<difference_type>(b.i);
+        }
+
+        bool operator==(const basic_iterator& o) const { return i == o.i; }
+        auto operator<=>(const basic_iterator& o) const { return i <=> o.i; }
+
+       private:
+        friend class gap_buffer;
+        basic_iterator(buffer_ptr buf, std::size_t i) : buf{buf}, i{i} {}
+
+        buffer_ptr buf{nullptr};
+        std::size_t i{0};  // posição lógica.
+    };
+
+   public:
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    // Construtores:
+    gap_buffer() noexcept(noexcept(Alloc())) = default;
+    explicit gap_buffer(const Alloc& a) noexcept : alloc{a} {}
+    template <std::input_iterator It>
+    gap_buffer(It first, It last, const Alloc& a = Alloc()) : alloc{a} {
+        insert(end(), first, last);
+    }
+    gap_buffer(std::initializer_list<T> il, const Alloc& a = Alloc())
+        : gap_buffer(il.begin(), il.end(), a) {}
+    gap_buffer(const gap_buffer& o)
+        : gap_buffer(o.begin(), o.end(),
+                     traits::select_on_container_copy_construction(o.alloc)) {
+    }
+    gap_buffer(gap_buffer&& o) noexcept
+        : alloc{std::move(o.alloc)},
+          data_{std::exchange(o.data_, nullptr)},
+          capacity_{std::exchange(o.capacity_, 0)},
+          gap_begin{std::exchange(o.gap_begin, 0)},
+          gap_end{std::exchange(o.gap_end, 0)} {}
+    ~gap_buffer() {
+        clear();
+        if (data_) traits::deallocate(alloc, data_, capacity_);
+    }
+
+    gap_buffer& operator=(gap_buffer o) noexcept {
+        swap(o);
+        return *this;
+    }
+
+    void swap(gap_buffer& o) noexcept {
+        using std::swap;
+        swap(alloc, o.alloc);
+        swap(data_, o.data_);
+        swap(capacity_, o.capacity_);
+        swap(gap_begin, o.gap_begin);
+        swap(gap_end, o.gap_end);
+    }
+    friend void swap(gap_buffer& a, gap_buffer& b) noexcept { a.swap(b); }
+
+    // Acesso aos elementos:
+    reference operator[](size_type i) { return data_[physical(i)]; }
+    const_reference operator[](size_type i) const {
+        return data_[physical(i)];
+    }
+    reference at(size_type i) {
+        if (i >= size()) throw std::out_of_range("gap_buffer::at");
+        return (*this)[i];
+    }
+    const_reference at(size_type i) const {
+        if (i >= size()) throw std::out_of_range("gap_buffer::at");
+        return (*this)[i];
+    }
+    reference front() { return (*this)[0]; }
+    const_reference front() const { return (*this)[0]; }
+    reference back() { return (*this)[size() - 1]; }
+    const_reference back() const { return (*this)[size() - 1]; }
+
+    // Iteradores:
+    iterator begin() noexcept { return {this, 0}; }
+    iterator end() noexcept { return {this, size()}; }
+    const_iterator begin() const noexcept { return {this, 0}; }
+    const_iterator end() const noexcept { return {this, size()}; }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    // Capacidade:
+    size_type size() const noexcept { return capacity_ - gap_size(); }
+    bool empty() const noexcept { return size() == 0; }
+    size_type capacity() const noexcept { return capacity_; }
+    void reserve(size_type n) {
+        if (n > capacity_) reallocate(n);
+    }
+
+    // Modificadores:
+    void clear() noexcept {
+        std::destroy_n(data_, gap_begin);
+        std::destroy(data_ + gap_end, data_ + capacity_);
+        gap_begin = 0;
+        gap_end = capacity_;
+    }
+
+    template <typename... Args>
+    iterator emplace(const_iterator pos, Args&&... args) {
+        // 'args' pode referenciar um elemento do próprio container, que é
+        // movido ao se deslocar a lacuna:
+        T tmp(std::forward<Args>(args)...);
+        auto idx = pos.i;
+        make_room(idx, 1);
+        traits::construct(alloc, data_ + gap_begin, std::move(tmp));
+        ++gap_begin;
+        return {this, idx};
+    }
+    iterator insert(const_iterator pos, const T& value) {
+        return emplace(pos, value);
+    }
+    iterator insert(const_iterator pos, T&& value) {
+        return emplace(pos, std::move(value));
+    }
+    iterator insert(const_iterator pos, size_type n, const T& value) {
+        T tmp(value);
+        auto idx = pos.i;
+        make_room(idx, n);
+        for (size_type k = 0; k < n; ++k) {
+            traits::construct(alloc, data_ + gap_begin, tmp);
+            ++gap_begin;
+        }
+        return {this, idx};
+    }
+    // '[first, last)' não deve referenciar elementos do próprio container.
+    template <std::input_iterator It>
+    iterator insert(const_iterator pos, It first, It last) {
+        auto idx = pos.i;
+        if constexpr (std::forward_iterator<It>) {
+            make_room(idx, static_cast<size_type>(std::distance(first, last)));
+        } else {
+            move_gap(idx);
+        }
+        for (; first != last; ++first) {
+            if (gap_begin == gap_end) grow(1);
+            traits::construct(alloc, data_ + gap_begin, *first);
+            ++gap_begin;
+        }
+        return {this, idx};
+    }
+    iterator insert(const_iterator pos, std::initializer_list<T> il) {
+        return insert(pos, il.begin(), il.end());
+    }
+
+    iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+    iterator erase(const_iterator first, const_iterator last) {
+        // A lacuna passa a começar em 'last', e os elementos em
+        // '[first, last)' (imediatamente antes dela) são absorvidos.
+        move_gap(last.i);
+        std::destroy(data_ + first.i, data_ + last.i);
+        gap_begin = first.i;
+        return {this, first.i};
+    }
+
+    void push_back(const T& value) { emplace(end(), value); }
+    void push_back(T&& value) { emplace(end(), std::move(value)); }
+    template <typename... Args>
+    reference emplace_back(Args&&... args) {
+        return *emplace(end(), std::forward<Args>(args)...);
+    }
+    void pop_back() { erase(end() - 1); }
+
+    friend bool operator==(const gap_buffer& a, const gap_buffer& b) {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end());
+    }
+    friend auto operator<=>(const gap_buffer& a, const gap_buffer& b) {
+        return std::lexicographical_compare_three_way(a.begin(), a.end(),
+                                                      b.begin(), b.end());
+    }
+
+   private:
+    size_type gap_size() const noexcept { return gap_end - gap_begin; }
+    size_type physical(size_type i) const noexcept {
+        return i < gap_begin ? i : i + gap_size();
+    }
+
+    // Garante 'n' posições livres e desloca a lacuna para a posição 'idx'.
+    void make_room(size_type idx, size_type n) {
+        if (gap_size() < n) grow(n);
+        move_gap(idx);
+    }
+
+    void move_gap(size_type idx) noexcept {
+        if (gap_size() == 0) {
+            // Lacuna vazia: não há elementos a mover.
+            gap_begin = gap_end = idx;
+        } else if (idx < gap_begin) {
+            // '[idx, gap_begin)' passa para o final da lacuna.
+            auto n = gap_begin - idx;
+            relocate_backward(data_ + idx, n, data_ + gap_end - n);
+            gap_begin -= n;
+            gap_end -= n;
+        } else if (idx > gap_begin) {
+            // Os 'n' primeiros elementos após a lacuna passam para o início.
+            auto n = idx - gap_begin;
+            relocate_forward(data_ + gap_end, n, data_ + gap_begin);
+            gap_begin += n;
+            gap_end += n;
+        }
+    }
+
+    // Transferem 'n' elementos de 'from' para 'to', possivelmente com
+    // sobreposição, destruindo os originais. Cada elemento é construído na
+    // posição livre mais próxima da lacuna, que avança uma posição por vez.
+    static void relocate_backward(T* from, size_type n, T* to) noexcept {
+        if constexpr (is_trivially_relocatable_v<T>) {
+            if (n) std::memmove(static_cast<void*>(to), from, n * sizeof(T));
+        } else {
+            for (size_type k = n; k-- > 0;) {
+                std::construct_at(to + k, std::move(from[k]));
+                std::destroy_at(from + k);
+            }
+        }
+    }
+    static void relocate_forward(T* from, size_type n, T* to) noexcept {
+        if constexpr (is_trivially_relocatable_v<T>) {
+            if (n) std::memmove(static_cast<void*>(to), from, n * sizeof(T));
+        } else {
+            for (size_type k = 0; k < n; ++k) {
+                std::construct_at(to + k, std::move(from[k]));
+                std::destroy_at(from + k);
+            }
+        }
+    }
+
+    void grow(size_type n) {
+        reallocate(std::max({capacity_ * 2, size() + n, min_capacity}));
+    }
+
+    // Novo bloco com capacidade 'n', preservando a posição da lacuna.
+    void reallocate(size_type n) {
+        T* target = traits::allocate(alloc, n);
+        auto tail = capacity_ - gap_end;
+        relocate_forward(data_, gap_begin, target);
+        relocate_forward(data_ + gap_end, tail, target + n - tail);
+        if (data_) traits::deallocate(alloc, data_, capacity_);
+        data_ = target;
+        gap_end = n - tail;
+        capacity_ = n;
+    }
+
+    [[no_unique_address]] Alloc alloc{};
+    T* data_{nullptr};
+    size_type capacity_{0};
+    size_type gap_begin{0};  // a lacuna ocupa '[gap_begin, gap_end)'.
+    size_type gap_end{0};
+};
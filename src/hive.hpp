@@ -0,0 +1,313 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Container do tipo 'hive' ('colony'), no estilo de 'std::hive' (C++26).
+//
+// Uma alternativa a 'std::list<std::shared_ptr<Widget>>' (item_42) quando a
+// ordem dos elementos não importa: os elementos são armazenados em blocos
+// contíguos de capacidade crescente, e nunca são movidos, portanto ponteiros e
+// iteradores permanecem válidos até a remoção do próprio elemento.
+//
+// - Inserção e remoção em O(1). As posições removidas de cada bloco formam uma
+//   lista livre e são reaproveitadas pelas próximas inserções.
+// - Blocos que ficam vazios não são desalocados, mas guardados para reuso
+//   (até '.trim()').
+// - A iteração percorre apenas os blocos com elementos vivos, e dentro de
+//   cada bloco salta as posições vazias com uma máscara de bits de ocupação,
+//   de forma que elementos removidos custam praticamente nada na iteração.
+//
+// A ordem de iteração não é a de inserção. Os iteradores são do tipo
+// 'forward'.
+template <typename T>
+class hive {
+    static constexpr std::size_t min_block = 16;
+    static constexpr std::size_t max_block = 8192;
+    static constexpr std::uint32_t no_slot = UINT32_MAX;
+
+    struct slot {
+        alignas(T) std::byte storage[std::max(sizeof(T),
+                                              sizeof(std::uint32_t))];
+
+        T* get() { return std::launder(reinterpret_cast<T*>(storage)); }
+        const T* get() const {
+            return std::launder(reinterpret_cast<const T*>(storage));
+        }
+        // Posições livres guardam o índice da próxima posição livre.
+        std::uint32_t next_free() const {
+            std::uint32_t n;
+            std::memcpy(&n, storage, sizeof(n));
+            return n;
+        }
+        void set_next_free(std::uint32_t n) {
+            std::memcpy(storage, &n, sizeof(n));
+        }
+    };
+
+    struct block {
+        explicit block(std::size_t capacity)
+            : capacity{capacity},
+              slots{std::make_unique<slot[]>(capacity)},
+              occupied{
+                  std::make_unique<std::uint64_t[]>((capacity + 63) / 64)} {}
+
+        // Primeira posição ocupada a partir de 'i' (ou 'high_water').
+        std::size_t next_occupied(std::size_t i) const {
+            while (i < high_water) {
+                auto word = occupied[i / 64] >> (i % 64);
+                if (word) {
+                    return std::min<std::size_t>(i + std::countr_zero(word),
+                                                 high_water);
+                }
+                i = (i / 64 + 1) * 64;
+            }
+            return high_water;
+        }
+
+        const std::size_t capacity;
+        std::unique_ptr<slot[]> slots;
+        std::unique_ptr<std::uint64_t[]> occupied;
+        std::size_t high_water{0};  // posições já utilizadas alguma vez.
+        std::size_t live{0};
+        std::uint32_t free_head{no_slot};
+
+        // Lista de blocos ativos (com elementos vivos).
+        block* prev{nullptr};
+        block* next{nullptr};
+        // Lista de blocos ativos com posições livres.
+        block* prev_with_free{nullptr};
+        block* next_with_free{nullptr};
+        bool in_free_list{false};
+    };
+
+   public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    template <bool Const>
+    class basic_iterator {
+        using block_ptr = std::conditional_t<Const, const block*, block*>;
+
+       public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const T*, T*>;
+        using reference = std::conditional_t<Const, const T&, T&>;
+
+        basic_iterator() = default;
+        basic_iterator(const basic_iterator&) = default;
+        basic_iterator& operator=(const basic_iterator&) = default;
+        // 'iterator' -> 'const_iterator'.
+        basic_iterator(const basic_iterator<false>& o)
+            requires Const
+            : b{o.b}, i{o.i} {}
+
+        reference operator*() const { return *b->slots[i].get(); }
+        pointer operator->() const { return b->slots[i].get(); }
+
+        basic_iterator& operator++() {
+            i = b->next_occupied(i + 1);
+            if (i == b->high_water) {
+                b = b->next;
+                i = b ? b->next_occupied(0) : 0;
+            }
+            return *this;
+        }
+        basic_iterator operator++(int) {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const basic_iterator& o) const {
+            return b == o.b && i == o.i;
+        }
+
+       private:
+        friend class hive;
+        basic_iterator(block_ptr b, std::size_t i) : b{b}, i{i} {}
+
+        block_ptr b{nullptr};
+        std::size_t i{0};
+    };
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    hive() = default;
+    hive(const hive& o) : hive() {
+        for (const auto& v : o) emplace(v);
+    }
+    hive(hive&& o) noexcept { swap(o); }
+    hive& operator=(hive o) noexcept {
+        swap(o);
+        return *this;
+    }
+    ~hive() {
+        clear();
+        trim();
+    }
+
+    void swap(hive& o) noexcept {
+        std::swap(head, o.head);
+        std::swap(tail, o.tail);
+        std::swap(with_free, o.with_free);
+        std::swap(reserved, o.reserved);
+        std::swap(count, o.count);
+        std::swap(next_capacity, o.next_capacity);
+    }
+
+    template <typename... Args>
+    iterator emplace(Args&&... args) {
+        block* b = block_with_room();
+        bool reuse = b->free_head != no_slot;
+        std::size_t i = reuse ? b->free_head : b->high_water;
+        auto next_free = reuse ? b->slots[i].next_free() : no_slot;
+        try {
+            ::new (b->slots[i].storage) T(std::forward<Args>(args)...);
+        } catch (...) {
+            // Um bloco recém-ativado não pode permanecer vazio na lista.
+            if (b->live == 0) retire(b);
+            throw;
+        }
+        if (reuse) {
+            b->free_head = next_free;
+            if (next_free == no_slot) unlink_with_free(b);
+        } else {
+            ++b->high_water;
+        }
+        b->occupied[i / 64] |= std::uint64_t{1} << (i % 64);
+        ++b->live;
+        ++count;
+        return {b, i};
+    }
+    iterator insert(const T& v) { return emplace(v); }
+    iterator insert(T&& v) { return emplace(std::move(v)); }
+
+    // Remove o elemento e retorna o iterador para o seguinte.
+    iterator erase(iterator it) {
+        auto next = std::next(it);
+        block* b = it.b;
+        std::size_t i = it.i;
+        b->slots[i].get()->~T();
+        b->occupied[i / 64] &= ~(std::uint64_t{1} << (i % 64));
+        --b->live;
+        --count;
+        if (b->live == 0) {
+            retire(b);
+        } else {
+            b->slots[i].set_next_free(b->free_head);
+            b->free_head = static_cast<std::uint32_t>(i);
+            push_with_free(b);
+        }
+        return next;
+    }
+
+    // Iterador para o elemento apontado por 'p' (O(número de blocos)).
+    iterator get_iterator(const T* p) {
+        for (block* b = head; b; b = b->next) {
+            auto* first = reinterpret_cast<const std::byte*>(b->slots.get());
+            auto* q = reinterpret_cast<const std::byte*>(p);
+            if (q >= first && q < first + b->capacity * sizeof(slot)) {
+                auto i = static_cast<std::size_t>(q - first) / sizeof(slot);
+                return {b, i};
+            }
+        }
+        return end();
+    }
+
+    iterator begin() {
+        return head ? iterator{head, head->next_occupied(0)} : end();
+    }
+    iterator end() { return {}; }
+    const_iterator begin() const {
+        return head ? const_iterator{head, head->next_occupied(0)} : end();
+    }
+    const_iterator end() const { return {}; }
+
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    void clear() {
+        while (head) {
+            block* b = head;
+            for (std::size_t i = b->next_occupied(0); i < b->high_water;
+                 i = b->next_occupied(i + 1)) {
+                b->slots[i].get()->~T();
+                b->occupied[i / 64] &= ~(std::uint64_t{1} << (i % 64));
+            }
+            count -= b->live;
+            b->live = 0;
+            retire(b);
+        }
+    }
+
+    // Libera os blocos vazios guardados para reuso.
+    void trim() {
+        while (reserved) delete std::exchange(reserved, reserved->next);
+    }
+
+   private:
+    block* block_with_room() {
+        if (with_free) return with_free;
+        if (tail && tail->high_water < tail->capacity) return tail;
+        block* b;
+        if (reserved) {
+            b = std::exchange(reserved, reserved->next);
+            b->next = nullptr;
+        } else {
+            b = new block{next_capacity};
+            next_capacity = std::min(next_capacity * 2, max_block);
+        }
+        b->prev = tail;
+        (tail ? tail->next : head) = b;
+        tail = b;
+        return b;
+    }
+
+    void push_with_free(block* b) {
+        if (b->in_free_list) return;
+        b->in_free_list = true;
+        b->prev_with_free = nullptr;
+        b->next_with_free = with_free;
+        if (with_free) with_free->prev_with_free = b;
+        with_free = b;
+    }
+    void unlink_with_free(block* b) {
+        (b->prev_with_free ? b->prev_with_free->next_with_free : with_free) =
+            b->next_with_free;
+        if (b->next_with_free) {
+            b->next_with_free->prev_with_free = b->prev_with_free;
+        }
+        b->prev_with_free = b->next_with_free = nullptr;
+        b->in_free_list = false;
+    }
+
+    // Retira um bloco vazio da lista de ativos e o guarda para reuso.
+    void retire(block* b) {
+        if (b->in_free_list) unlink_with_free(b);
+        (b->prev ? b->prev->next : head) = b->next;
+        (b->next ? b->next->prev : tail) = b->prev;
+        b->prev = nullptr;
+        b->high_water = 0;
+        b->free_head = no_slot;
+        b->next = reserved;
+        reserved = b;
+    }
+
+    block* head{nullptr};
+    block* tail{nullptr};
+    block* with_free{nullptr};  // blocos ativos com posições livres.
+    block* reserved{nullptr};   // blocos vazios guardados para reuso.
+    std::size_t count{0};
+    std::size_t next_capacity{min_block};
+};
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Objeto de função com 'type erasure' e armazenamento interno fixo.
+//
+// 'std::function' (como em 'vector<std::function<int()>>' do item_31) aloca
+// memória na 'heap' sempre que o objeto invocável (eg, uma 'lambda' com suas
+// capturas) não cabe no seu pequeno 'buffer' interno. 'inplace_function'
+// sempre armazena o invocável no próprio objeto, num 'buffer' de 'Capacity'
+// bytes alinhado a 'Align', e rejeita em tempo de compilação invocáveis que
+// não caibam nele: nunca há alocação.
+//
+// Assim como 'std::move_only_function', 'inplace_function' pode ser apenas
+// movido, e por isso aceita invocáveis que não podem ser copiados (eg, uma
+// 'lambda' que captura um 'std::unique_ptr'). Invocar um objeto vazio lança
+// 'std::bad_function_call'.
+template <typename Signature, std::size_t Capacity = 32,
+          std::size_t Align = alignof(std::max_align_t)>
+class inplace_function;
+
+template <typename R, typename... Args, std::size_t Capacity,
+          std::size_t Align>
+class inplace_function<R(Args...), Capacity, Align> {
+    // Operações do invocável armazenado. Cada tipo de invocável possui a sua
+    // própria tabela estática; o objeto vazio aponta para 'empty_vtable', de
+    // forma que a invocação nunca precise verificar se há um invocável.
+    // Invocáveis 'trivially copyable' (eg, 'lambdas' que capturam apenas
+    // valores escalares) são movidos com 'memcpy' e não precisam ser
+    // destruídos, evitando as chamadas indiretas.
+    struct vtable {
+        R (*invoke)(void*, Args&&...);
+        void (*move)(void* dst, void* src) noexcept;  // e destrói 'src'.
+        void (*destroy)(void*) noexcept;
+        bool trivial;
+    };
+
+    static constexpr vtable empty_vtable{
+        [](void*, Args&&...) -> R { throw std::bad_function_call{}; },
+        [](void*, void*) noexcept {},
+        [](void*) noexcept {},
+        true,
+    };
+
+    template <typename F>
+    static constexpr vtable vtable_for{
+        [](void* f, Args&&... args) -> R {
+            return std::invoke_r<R>(*static_cast<F*>(f),
+                                    std::forward<Args>(args)...);
+        },
+        [](void* dst, void* src) noexcept {
+            ::new (dst) F(std::move(*static_cast<F*>(src)));
+            static_cast<F*>(src)->~F();
+        },
+        [](void* f) noexcept { static_cast<F*>(f)->~F(); },
+        std::is_trivially_copyable_v<F>,
+    };
+
+   public:
+    static constexpr std::size_t capacity = Capacity;
+
+    inplace_function() noexcept = default;
+    inplace_function(std::nullptr_t) noexcept {}
+
+    template <typename Fn, typename F = std::decay_t<Fn>>
+        requires(!std::is_same_v<F, inplace_function> &&
+                 std::is_invocable_r_v<R, F&, Args...>)
+    inplace_function(Fn&& fn) {
+        static_assert(sizeof(F) <= Capacity,
+                      "Invocável não cabe em 'inplace_function': aumente "
+                      "'Capacity'.");
+        static_assert(Align % alignof(F) == 0,
+                      "Alinhamento do invocável incompatível com 'Align'.");
+        static_assert(std::is_nothrow_move_constructible_v<F>,
+                      "O invocável deve ser 'nothrow move constructible'.");
+        if constexpr (std::is_pointer_v<F> ||
+                      std::is_member_pointer_v<F>) {
+            if (fn == nullptr) return;
+        }
+        ::new (static_cast<void*>(storage)) F(std::forward<Fn>(fn));
+        ops = &vtable_for<F>;
+    }
+
+    inplace_function(inplace_function&& o) noexcept { take(o); }
+    inplace_function& operator=(inplace_function&& o) noexcept {
+        if (this != &o) {
+            reset();
+            take(o);
+        }
+        return *this;
+    }
+    inplace_function& operator=(std::nullptr_t) noexcept {
+        reset();
+        return *this;
+    }
+    template <typename Fn>
+        requires std::is_constructible_v<inplace_function, Fn>
+    inplace_function& operator=(Fn&& fn) {
+        return *this = inplace_function(std::forward<Fn>(fn));
+    }
+
+    inplace_function(const inplace_function&) = delete;
+    inplace_function& operator=(const inplace_function&) = delete;
+
+    ~inplace_function() { reset(); }
+
+    R operator()(Args... args) {
+        return ops->invoke(storage, std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const noexcept { return ops != &empty_vtable; }
+
+    friend void swap(inplace_function& a, inplace_function& b) noexcept {
+        inplace_function tmp{std::move(a)};
+        a = std::move(b);
+        b = std::move(tmp);
+    }
+
+   private:
+    void take(inplace_function& o) noexcept {
+        ops = std::exchange(o.ops, &empty_vtable);
+        if (ops->trivial) {
+            std::memcpy(storage, o.storage, Capacity);
+        } else {
+            ops->move(storage, o.storage);
+        }
+    }
+    void reset() noexcept {
+        if (!ops->trivial) ops->destroy(storage);
+        ops = &empty_vtable;
+    }
+
+    const vtable* ops{&empty_vtable};
+    alignas(Align) std::byte storage[Capacity];
+};
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "append_only_vector.hpp"
+
+// Tabela de 'interning' de 'strings'.
+//
+// Cada 'string' distinta é armazenada uma única vez e identificada por um
+// símbolo de 32 bits. Comparar dois símbolos equivale a comparar as 'strings'
+// correspondentes, mas custa apenas uma comparação de inteiros. Útil quando
+// um mesmo conjunto pequeno de 'strings' se repete muitas vezes (eg, os nomes
+// de 'name_from_idx' acumulados em 'names' nos itens 26 e 27).
+//
+// - Os caracteres são armazenados em blocos ('arena') que nunca são movidos
+//   nem liberados antes da tabela, de forma que os 'std::string_view'
+//   retornados permanecem válidos durante toda a vida da tabela.
+// - Leituras ('.find()', '.view()' e o caminho de '.intern()' para 'strings'
+//   já existentes) não utilizam 'locks'. Apenas a inserção de uma 'string'
+//   nova é serializada por um 'std::mutex'.
+class intern_table {
+   public:
+    using symbol = std::uint32_t;
+
+    intern_table() { publish_index(16); }
+    intern_table(const intern_table&) = delete;
+    intern_table& operator=(const intern_table&) = delete;
+
+    symbol intern(std::string_view s) {
+        if (auto id = find(s)) return *id;
+        std::scoped_lock lock{write_mutex};
+        if (auto id = find(s)) return *id;  // inserida por outra 'thread'.
+
+        auto id = static_cast<symbol>(views.size());
+        views.emplace_back(store(s));
+        index* idx = current.load(std::memory_order_relaxed);
+        if ((views.size() + 1) * 2 > idx->capacity()) {
+            idx = publish_index(idx->capacity() * 2);
+        } else {
+            insert(*idx, id);
+        }
+        return id;
+    }
+
+    std::optional<symbol> find(std::string_view s) const {
+        const index* idx = current.load(std::memory_order_acquire);
+        auto mask = idx->capacity() - 1;
+        for (auto i = hash(s) & mask;; i = (i + 1) & mask) {
+            auto v = idx->slots[i].load(std::memory_order_acquire);
+            if (v == 0) return std::nullopt;
+            if (view(v - 1) == s) return v - 1;
+        }
+    }
+
+    std::string_view view(symbol id) const { return views[id]; }
+
+    std::size_t size() const { return views.size(); }
+    // Memória ocupada pelos caracteres armazenados (blocos inteiros).
+    std::size_t arena_bytes() const {
+        std::scoped_lock lock{write_mutex};
+        return chunks.size() * chunk_size + oversized_bytes;
+    }
+
+   private:
+    static constexpr std::size_t chunk_size = 64 * 1024;
+
+    // Índice 'string -> símbolo' por endereçamento aberto. Cada posição
+    // guarda 'símbolo + 1' (0 indica posição vazia).
+    struct index {
+        explicit index(std::size_t cap)
+            : cap{cap}, slots{std::make_unique<std::atomic<symbol>[]>(cap)} {}
+        std::size_t capacity() const { return cap; }
+
+        std::size_t cap;
+        std::unique_ptr<std::atomic<symbol>[]> slots;
+    };
+
+    static std::size_t hash(std::string_view s) {
+        return std::hash<std::string_view>{}(s);
+    }
+
+    void insert(index& idx, symbol id) {
+        auto mask = idx.capacity() - 1;
+        for (auto i = hash(view(id)) & mask;; i = (i + 1) & mask) {
+            if (idx.slots[i].load(std::memory_order_relaxed) == 0) {
+                idx.slots[i].store(id + 1, std::memory_order_release);
+                return;
+            }
+        }
+    }
+
+    // Constrói um novo índice com todas as 'strings' e o publica. Índices
+    // antigos são mantidos até a destruição da tabela, pois leitores podem
+    // ainda estar percorrendo-os.
+    index* publish_index(std::size_t cap) {
+        auto fresh = std::make_unique<index>(cap);
+        for (symbol id = 0; id < views.size(); ++id) insert(*fresh, id);
+        index* p = fresh.get();
+        indexes.push_back(std::move(fresh));
+        current.store(p, std::memory_order_release);
+        return p;
+    }
+
+    // Copia os caracteres de 's' para a 'arena'.
+    std::string_view store(std::string_view s) {
+        if (s.empty()) return {};
+        if (s.size() > chunk_size / 4) {
+            // 'strings' grandes recebem um bloco exclusivo.
+            auto& block = oversized.emplace_back(new char[s.size()]);
+            oversized_bytes += s.size();
+            std::memcpy(block.get(), s.data(), s.size());
+            return {block.get(), s.size()};
+        }
+        if (chunks.empty() || chunk_used + s.size() > chunk_size) {
+            chunks.emplace_back(new char[chunk_size]);
+            chunk_used = 0;
+        }
+        char* dst = chunks.back().get() + chunk_used;
+        std::memcpy(dst, s.data(), s.size());
+        chunk_used += s.size();
+        return {dst, s.size()};
+    }
+
+    append_only_vector<std::string_view> views;
+    std::atomic<index*> current{nullptr};
+    std::vector<std::unique_ptr<index>> indexes;
+
+    mutable std::mutex write_mutex;
+    std::vector<std::unique_ptr<char[]>> chunks;
+    std::size_t chunk_used{0};
+    std::vector<std::unique_ptr<char[]>> oversized;
+    std::size_t oversized_bytes{0};
+};
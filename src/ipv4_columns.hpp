@@ -0,0 +1,167 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+// Decodificação em lote de cabeçalhos IPv4 para arranjos por coluna.
+//
+// Os campos de 'item_30::IPv4Header' (versão, IHL, DSCP, ECN e comprimento
+// total) ocupam os 4 primeiros bytes do cabeçalho, em ordem de rede
+// ('big-endian'):
+//
+//   byte 0: versão (4 bits mais altos) | IHL (4 bits mais baixos)
+//   byte 1: DSCP (6 bits mais altos)   | ECN (2 bits mais baixos)
+//   bytes 2 e 3: comprimento total
+//
+// Note que o 'bitfield' de 'IPv4Header' não corresponde a este 'layout' em
+// arquiteturas 'little-endian' (a ordem dos campos dentro de cada byte e a dos
+// bytes do comprimento total ficam invertidas), portanto os bytes recebidos
+// não podem simplesmente ser reinterpretados como 'IPv4Header'.
+//
+// Para análises sobre muitos cabeçalhos, é mais eficiente extrair cada campo
+// para o seu próprio arranjo ('structure of arrays'), que pode então ser
+// percorrido sequencialmente (e vetorizado) pelo compilador. Os cabeçalhos de
+// entrada estão armazenados contiguamente, a cada 'stride' bytes (20, o
+// tamanho mínimo do cabeçalho, por padrão). As versões AVX2 e SSE4.1 são
+// selecionadas em tempo de compilação ('-march=native'), com uma versão
+// escalar para as demais arquiteturas.
+struct IPv4Columns {
+    std::vector<std::uint8_t> version;
+    std::vector<std::uint8_t> IHL;
+    std::vector<std::uint8_t> DSCP;
+    std::vector<std::uint8_t> ECN;
+    std::vector<std::uint16_t> total_length;
+
+    std::size_t size() const { return total_length.size(); }
+    void resize(std::size_t n) {
+        version.resize(n);
+        IHL.resize(n);
+        DSCP.resize(n);
+        ECN.resize(n);
+        total_length.resize(n);
+    }
+};
+
+inline constexpr std::size_t ipv4_min_header_size = 20;
+
+namespace ipv4_kernels {
+
+// Ponteiros de saída de cada coluna.
+struct Out {
+    std::uint8_t* version;
+    std::uint8_t* IHL;
+    std::uint8_t* DSCP;
+    std::uint8_t* ECN;
+    std::uint16_t* total_length;
+};
+
+inline void scalar(const std::byte* raw, std::size_t count,
+                   std::size_t stride, Out out, std::size_t first = 0) {
+    for (std::size_t i = first; i < count; ++i) {
+        const auto* h = reinterpret_cast<const std::uint8_t*>(raw + i * stride);
+        out.version[i] = h[0] >> 4;
+        out.IHL[i] = h[0] & 0x0F;
+        out.DSCP[i] = h[1] >> 2;
+        out.ECN[i] = h[1] & 0x03;
+        out.total_length[i] = static_cast<std::uint16_t>(h[2] << 8 | h[3]);
+    }
+}
+
+#if defined(__SSE4_1__)
+// Extrai os campos de 4 palavras de 32 bits (os 4 primeiros bytes de cada
+// cabeçalho, lidos em 'little-endian') e os grava nas colunas a partir de
+// 'i'. 'w' contém as palavras dos cabeçalhos 'i' a 'i + 3' e 'w_hi' as dos
+// cabeçalhos 'i + 4' a 'i + 7'.
+inline void store8(__m128i w, __m128i w_hi, Out out, std::size_t i) {
+    auto field = [&](int shift, int mask) {
+        auto m = _mm_set1_epi32(mask);
+        auto lo = _mm_and_si128(_mm_srli_epi32(w, shift), m);
+        auto hi = _mm_and_si128(_mm_srli_epi32(w_hi, shift), m);
+        return _mm_packus_epi32(lo, hi);  // 8 valores de 16 bits.
+    };
+    auto store_u8 = [](std::uint8_t* dst, __m128i v16) {
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst),
+                         _mm_packus_epi16(v16, v16));
+    };
+    store_u8(out.version + i, field(4, 0x0F));
+    store_u8(out.IHL + i, field(0, 0x0F));
+    store_u8(out.DSCP + i, field(10, 0x3F));
+    store_u8(out.ECN + i, field(8, 0x03));
+    // Comprimento total: troca a ordem dos bytes 2 e 3.
+    auto swap = _mm_setr_epi8(3, 2, -1, -1, 7, 6, -1, -1, 11, 10, -1, -1, 15,
+                              14, -1, -1);
+    auto len = _mm_packus_epi32(_mm_shuffle_epi8(w, swap),
+                                _mm_shuffle_epi8(w_hi, swap));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out.total_length + i), len);
+}
+
+// Os 4 primeiros bytes de 4 cabeçalhos consecutivos.
+inline __m128i load4(const std::byte* p, std::size_t stride) {
+    int w[4];
+    for (int k = 0; k < 4; ++k) std::memcpy(&w[k], p + k * stride, 4);
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(w));
+}
+
+inline void sse(const std::byte* raw, std::size_t count, std::size_t stride,
+                Out out) {
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const std::byte* p = raw + i * stride;
+        store8(load4(p, stride), load4(p + 4 * stride, stride), out, i);
+    }
+    scalar(raw, count, stride, out, i);
+}
+#endif
+
+#if defined(__AVX2__)
+// Os 4 primeiros bytes de 8 cabeçalhos são obtidos com um único 'gather'.
+inline void avx2(const std::byte* raw, std::size_t count, std::size_t stride,
+                 Out out) {
+    if (stride * 8 > static_cast<std::size_t>(INT32_MAX)) {
+        return sse(raw, count, stride, out);
+    }
+    auto s = static_cast<int>(stride);
+    auto offsets =
+        _mm256_setr_epi32(0, s, 2 * s, 3 * s, 4 * s, 5 * s, 6 * s, 7 * s);
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        auto w = _mm256_i32gather_epi32(
+            reinterpret_cast<const int*>(raw + i * stride), offsets, 1);
+        store8(_mm256_castsi256_si128(w), _mm256_extracti128_si256(w, 1), out,
+               i);
+    }
+    scalar(raw, count, stride, out, i);
+}
+#endif
+
+}  // namespace ipv4_kernels
+
+// Decodifica todos os cabeçalhos completos de 'raw' para 'out' (que é
+// redimensionado). Bytes finais que não completam um cabeçalho são ignorados.
+inline void decode_ipv4_headers(std::span<const std::byte> raw,
+                                IPv4Columns& out,
+                                std::size_t stride = ipv4_min_header_size) {
+    if (stride < 4) {
+        throw std::invalid_argument(
+            "decode_ipv4_headers: 'stride' deve ser de pelo menos 4 bytes.");
+    }
+    std::size_t count = raw.size() / stride;
+    out.resize(count);
+    ipv4_kernels::Out o{out.version.data(), out.IHL.data(), out.DSCP.data(),
+                        out.ECN.data(), out.total_length.data()};
+#if defined(__AVX2__)
+    ipv4_kernels::avx2(raw.data(), count, stride, o);
+#elif defined(__SSE4_1__)
+    ipv4_kernels::sse(raw.data(), count, stride, o);
+#else
+    ipv4_kernels::scalar(raw.data(), count, stride, o);
+#endif
+}
@@ -5,11 +5,15 @@
 #include <list>
 #include <memory>
 #include <print>
+#include <random>
 #include <ranges>
 #include <type_traits>
 #include <unordered_map>
 #include <vector>
 
+#include "bench.hpp"
+#include "gap_buffer.hpp"
+
 namespace item_13 {
 using boost::typeindex::type_id_with_cvr;
 using std::cout;
@@ -45,5 +49,54 @@ void main() {
         v.insert(it, {24, 42});
     }
     cout << "modified 'v': " << stringify(v) << endl;
+
+    // 'gap_buffer' (./gap_buffer.hpp) possui a mesma interface de inserção
+    // por iterador, mas não desloca toda a cauda a cada inserção:
+    cout << endl;
+    gap_buffer<int> g = vw::iota(0, 10) | rg::to<gap_buffer<int>>();
+    cout << "original 'g': " << stringify(g) << endl;
+    auto git = std::find(std::cbegin(g), std::cend(g), 4);
+    if (git != std::cend(g)) {
+        g.insert(git, {24, 42});
+    }
+    cout << "modified 'g': " << stringify(g) << endl;
+
+    // 20'000 inserções numa sequência de 100'000 elementos, em posições
+    // próximas da anterior (como na edição de texto) e em posições aleatórias:
+    cout << endl;
+    constexpr int initial = 100'000;
+    constexpr int inserts = 20'000;
+    auto run = [&]<typename C>(std::type_identity<C>, bool localized) {
+        C c = vw::iota(0, initial) | rg::to<C>();
+        std::mt19937 rng{42};
+        std::size_t cursor = c.size() / 2;
+        auto t = time_ms([&] {
+            for (int i = 0; i < inserts; ++i) {
+                if (localized) {
+                    // O cursor avança após cada inserção e, às vezes, salta
+                    // algumas posições.
+                    auto jump = static_cast<int>(rng() % 17) - 8;
+                    cursor = std::clamp<std::ptrdiff_t>(
+                        static_cast<std::ptrdiff_t>(cursor) +
+                            (i % 16 == 0 ? jump : 1),
+                        0, static_cast<std::ptrdiff_t>(c.size()));
+                } else {
+                    cursor = rng() % (c.size() + 1);
+                }
+                c.insert(std::cbegin(c) + static_cast<std::ptrdiff_t>(cursor),
+                         i);
+            }
+        });
+        do_not_optimize(c[0]);
+        return t;
+    };
+    for (bool localized : {true, false}) {
+        std::println("{}:", localized ? "Inserções próximas"
+                                      : "Inserções aleatórias");
+        std::println("  vector:     {:.2f} ms",
+                     run(std::type_identity<vector<int>>{}, localized));
+        std::println("  gap_buffer: {:.2f} ms",
+                     run(std::type_identity<gap_buffer<int>>{}, localized));
+    }
 };
 }  // namespace item_13
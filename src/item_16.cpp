@@ -1,6 +1,7 @@
 #include <atomic>
 #include <boost/type_index.hpp>
 #include <functional>
+#include <future>
 #include <iostream>
 #include <list>
 #include <memory>
@@ -13,6 +14,8 @@
 #include <unordered_map>
 #include <vector>
 
+#include "thread_pool.hpp"
+
 namespace item_16 {
 using boost::typeindex::type_id_with_cvr;
 using std::cout;
@@ -111,13 +114,13 @@ void main() {
             std::osyncstream out{cout};
             out << stringify(obj.calc_a()) << endl;
         };
-        std::jthread t1{f, std::ref(foo)};
-        std::jthread t2{f, std::ref(foo)};
-        std::jthread t3{f, std::ref(foo)};
-        std::jthread t4{f, std::ref(foo)};
-        std::jthread t5{f, std::ref(foo)};
-        std::jthread t6{f, std::ref(foo)};
-        std::jthread t7{f, std::ref(foo)};
+        // As invocações concorrentes são executadas pelas 'threads' de
+        // './thread_pool.hpp', ao invés de uma nova 'thread' por invocação.
+        vector<std::future<void>> futures;
+        for (int _ : vw::iota(0, 7)) {
+            futures.push_back(pool_async(f, std::ref(foo)));
+        }
+        for (auto& fut : futures) fut.get();
     };
     {
         cout << endl;
@@ -126,13 +129,11 @@ void main() {
             std::osyncstream out{cout};
             out << stringify(obj.calc_a()) << endl;
         };
-        std::jthread t1{f, std::ref(foo)};
-        std::jthread t2{f, std::ref(foo)};
-        std::jthread t3{f, std::ref(foo)};
-        std::jthread t4{f, std::ref(foo)};
-        std::jthread t5{f, std::ref(foo)};
-        std::jthread t6{f, std::ref(foo)};
-        std::jthread t7{f, std::ref(foo)};
+        vector<std::future<void>> futures;
+        for (int _ : vw::iota(0, 7)) {
+            futures.push_back(pool_async(f, std::ref(foo)));
+        }
+        for (auto& fut : futures) fut.get();
     };
     // No mesmo sentido, deve-se fortemente evitar o uso de mais de uma variável
     // 'std::atomic<T>' por contexto de 'thread'. Pode-se acabar realizando
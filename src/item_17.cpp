@@ -6,11 +6,15 @@
 #include <map>
 #include <memory>
 #include <print>
+#include <random>
 #include <ranges>
 #include <type_traits>
 #include <unordered_map>
 #include <vector>
 
+#include "bench.hpp"
+#include "flat_map.hpp"
+
 namespace item_17 {
 using boost::typeindex::type_id_with_cvr;
 using std::cout;
@@ -147,5 +151,50 @@ void main() {
     {
         cout << endl;
     };
+    {
+        // 'Bar1::values' e 'Bar2::values' são 'std::map<int, std::string>'.
+        // Para mapas construídos de uma vez e depois apenas consultados,
+        // 'flat_map' (./flat_map.hpp) evita uma alocação por elemento e a
+        // busca percorre um arranjo contíguo de chaves. Construção e
+        // 1'000'000 de buscas (metade delas de chaves ausentes):
+        constexpr int queries = 1'000'000;
+        for (int n : {10, 1'000, 100'000, 1'000'000}) {
+            std::mt19937 rng{42};
+            vector<std::pair<int, string>> entries;
+            entries.reserve(static_cast<std::size_t>(n));
+            for (int i = 0; i < n; ++i) {
+                // Chaves pares; as ímpares são buscas sem sucesso.
+                entries.emplace_back(2 * static_cast<int>(rng() % (4u * n)),
+                                     "v" + to_string(i));
+            }
+            // Cada busca sorteia uma chave presente e, com probabilidade de
+            // 1/2, a troca pela ímpar seguinte (ausente).
+            vector<int> lookups(queries);
+            for (auto& k : lookups) {
+                k = entries[rng() % static_cast<unsigned>(n)].first +
+                    static_cast<int>(rng() % 2);
+            }
+
+            std::map<int, string> map;
+            flat_map<int, string> flat;
+            auto map_build = time_ms([&] {
+                for (const auto& e : entries) map.insert(e);
+            });
+            auto flat_build = time_ms([&] { flat.insert_range(entries); });
+            std::size_t found = 0;
+            auto map_query = time_ms([&] {
+                for (int k : lookups) found += map.contains(k);
+            });
+            auto flat_query = time_ms([&] {
+                for (int k : lookups) found += flat.contains(k);
+            });
+            do_not_optimize(found);
+            std::println("n = {}:", n);
+            std::println("  std::map: construção {:.2f} ms | buscas {:.2f} ms",
+                         map_build, map_query);
+            std::println("  flat_map: construção {:.2f} ms | buscas {:.2f} ms",
+                         flat_build, flat_query);
+        }
+    };
 };
 }  // namespace item_17
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <boost/type_index.hpp>
 #include <functional>
 #include <iostream>
@@ -5,10 +6,15 @@
 #include <memory>
 #include <print>
 #include <ranges>
+#include <thread>
 #include <type_traits>
 #include <unordered_map>
 #include <vector>
 
+#include "append_only_vector.hpp"
+#include "bench.hpp"
+#include "deferred_delete.hpp"
+
 namespace item_19 {
 using boost::typeindex::type_id_with_cvr;
 using std::cout;
@@ -49,9 +55,24 @@ class Widget2 : public std::enable_shared_from_this<Widget2> {
     //     _i = i;
     // };
 
-    std::shared_ptr<vector<std::shared_ptr<Widget2>>> _v;
+    // std::shared_ptr<vector<std::shared_ptr<Widget2>>> _v;
+    // int _i{0};
+    // Widget2(std::shared_ptr<vector<std::shared_ptr<Widget2>>>& v, int i) {
+    //     _v = v;
+    //     _i = i;
+    // };
+
+    // O registro compartilhado entre os objetos é um vetor 'append-only'
+    // concorrente (./append_only_vector.hpp), de forma que '.do_stuff()' possa
+    // ser invocado simultaneamente por várias 'threads' sem sincronização
+    // adicional.
+   public:
+    using Registry = append_only_vector<std::shared_ptr<Widget2>>;
+
+   private:
+    std::shared_ptr<Registry> _v;
     int _i{0};
-    Widget2(std::shared_ptr<vector<std::shared_ptr<Widget2>>>& v, int i) {
+    Widget2(std::shared_ptr<Registry>& v, int i) {
         _v = v;
         _i = i;
     };
@@ -65,8 +86,8 @@ class Widget2 : public std::enable_shared_from_this<Widget2> {
 
     // static std::shared_ptr<Widget2> create(vector<std::shared_ptr<Widget2>>*
     // v, int i) {
-    static std::shared_ptr<Widget2> create(
-        std::shared_ptr<vector<std::shared_ptr<Widget2>>>& v, int i) {
+    static std::shared_ptr<Widget2> create(std::shared_ptr<Registry>& v,
+                                           int i) {
         return std::shared_ptr<Widget2>(new Widget2{v, i});
     }
     void do_stuff() {
@@ -178,9 +199,8 @@ void main() {
         // para outras estruturas de dados (no caso, um vetor de ponteiros
         // 'std::shared_ptr<Widget2>').
         cout << endl;
-        auto svspw = std::make_shared<vector<std::shared_ptr<Widget2>>>();
-        cout << "svspw = std::make_shared<vector<std::shared_ptr<Widget2>>>();"
-             << endl;
+        auto svspw = std::make_shared<Widget2::Registry>();
+        cout << "svspw = std::make_shared<Widget2::Registry>();" << endl;
         auto w1 = Widget2::create(svspw, 24);
         auto w2 = Widget2::create(svspw, 42);
         auto w3 = Widget2::create(svspw, 8);
@@ -195,6 +215,52 @@ void main() {
              << stringify(*svspw |
                           vw::transform([](auto& a) { return a->get_i(); }))
              << endl;
+
+        // O registro pode receber inserções de várias 'threads'
+        // simultaneamente. Os endereços dos elementos já inseridos permanecem
+        // estáveis, e a iteração concorrente visita apenas os elementos já
+        // publicados:
+        {
+            vector<std::jthread> threads;
+            for (int t = 0; t < 4; ++t) {
+                threads.emplace_back([&svspw, t] {
+                    for (int i = 0; i < 1000; ++i) {
+                        Widget2::create(svspw, t * 1000 + i)->do_stuff();
+                    }
+                });
+            }
+        }
+        cout << "4 threads x 1000 x Widget2::create(svspw, i)->do_stuff();"
+             << endl;
+        cout << "svspw.size(): " << svspw->size() << endl;
+    }
+    {
+        // Quando o último 'std::shared_ptr' de um objeto grande é destruído, o
+        // destrutor do recurso é executado na própria 'thread' que liberou o
+        // ponteiro. Com 'deferred_deleter' (./deferred_delete.hpp) o objeto é
+        // repassado para uma fila e destruído por uma 'thread' de fundo,
+        // removendo o custo da desalocação do caminho crítico:
+        cout << endl;
+        using Graph = vector<vector<double>>;
+        auto make_graph = [] {
+            return Graph(100'000, vector<double>(16, 1.0));
+        };
+
+        reclamation_queue queue;
+        double worst_direct = 0.0;
+        double worst_deferred = 0.0;
+        for (int i = 0; i < 10; ++i) {
+            auto direct = std::make_shared<Graph>(make_graph());
+            worst_direct = std::max(worst_direct,
+                                    time_ms([&] { direct.reset(); }));
+
+            auto deferred = make_deferred_shared<Graph>(queue, make_graph());
+            worst_deferred = std::max(worst_deferred,
+                                      time_ms([&] { deferred.reset(); }));
+        }
+        std::println("pior 'reset()' | direto: {:.3f} ms | adiado: {:.3f} ms",
+                     worst_direct, worst_deferred);
+        cout << "queue.backlog(): " << queue.backlog() << endl;
     }
 };
 }  // namespace item_19
@@ -1,3 +1,4 @@
+#include <atomic>
 #include <boost/type_index.hpp>
 #include <functional>
 #include <iostream>
@@ -5,10 +6,14 @@
 #include <memory>
 #include <print>
 #include <ranges>
+#include <thread>
 #include <type_traits>
 #include <unordered_map>
 #include <vector>
 
+#include "bench.hpp"
+#include "epoch_reclamation.hpp"
+
 namespace item_20 {
 using boost::typeindex::type_id_with_cvr;
 using std::cout;
@@ -114,5 +119,70 @@ void main() {
         }
         observe();
     };
+    {
+        // Quando um objeto compartilhado é lido por várias 'threads' e
+        // substituído de tempos em tempos por um escritor, o uso de
+        // 'std::shared_ptr' (ou de 'std::weak_ptr::lock()') implica alterar um
+        // contador atômico compartilhado a cada leitura. Com recuperação
+        // baseada em épocas (./epoch_reclamation.hpp), o leitor apenas publica
+        // a época observada e acessa o ponteiro cru; o objeto substituído só é
+        // destruído quando nenhum leitor puder mais acessá-lo.
+        cout << endl;
+        constexpr int readers = 4;
+        constexpr int reads = 1'000'000;
+
+        // Executa 'readers' leitores até o fim e um escritor que substitui o
+        // objeto continuamente enquanto houver leitores ativos.
+        auto run = [](auto read_one, auto replace) {
+            std::atomic<int> running{readers};
+            return time_ms([&] {
+                std::jthread writer{[&] {
+                    for (int i = 0; running.load() > 0; ++i) replace(i);
+                }};
+                vector<std::jthread> threads;
+                for (int t = 0; t < readers; ++t) {
+                    threads.emplace_back([&] {
+                        long total = 0;
+                        for (int i = 0; i < reads; ++i) total += read_one();
+                        do_not_optimize(total);
+                        running.fetch_sub(1);
+                    });
+                }
+            });
+        };
+
+        std::atomic<std::shared_ptr<Foo>> asp{std::make_shared<Foo>(0)};
+        auto t_atomic_sp =
+            run([&] { return asp.load()->x; },
+                [&](int i) { asp.store(std::make_shared<Foo>(i)); });
+
+        // Padrão de 'cache'/'Observer' acima: cada leitor possui o seu
+        // 'std::weak_ptr' e realiza '.lock()' a cada acesso. Aqui o objeto
+        // observado não é substituído, medindo apenas o custo do '.lock()'.
+        auto owner = std::make_shared<Foo>(0);
+        auto t_weak = run(
+            [&] {
+                thread_local std::weak_ptr<Foo> local{owner};
+                auto sp = local.lock();
+                return sp ? sp->x : 0;
+            },
+            [](int) { std::this_thread::yield(); });
+
+        epoch_domain domain;
+        std::atomic<Foo*> ebr{new Foo{0}};
+        auto t_ebr = run(
+            [&] {
+                epoch_domain::guard g{domain};
+                return ebr.load(std::memory_order_acquire)->x;
+            },
+            [&](int i) { domain.retire(ebr.exchange(new Foo{i})); });
+        delete ebr.load();
+
+        std::println("leitores: {} x {} leituras", readers, reads);
+        std::println("std::atomic<std::shared_ptr<Foo>>: {:.2f} ms",
+                     t_atomic_sp);
+        std::println("std::weak_ptr<Foo>::lock():        {:.2f} ms", t_weak);
+        std::println("epoch_domain::guard:               {:.2f} ms", t_ebr);
+    };
 };
 }  // namespace item_20
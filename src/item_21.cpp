@@ -1,3 +1,4 @@
+#include <array>
 #include <boost/type_index.hpp>
 #include <functional>
 #include <iostream>
@@ -9,6 +10,8 @@
 #include <unordered_map>
 #include <vector>
 
+#include "weak_aware_shared.hpp"
+
 namespace item_21 {
 using boost::typeindex::type_id_with_cvr;
 using std::cout;
@@ -169,5 +172,48 @@ void main() {
         // quantidade de ponteiros 'std::shared_ptr' e 'std::weak_ptr' ainda
         // presentes.
     }
+    {
+        // As funções de './weak_aware_shared.hpp' permitem observar e evitar
+        // essa retenção. 'weak_retained_bytes()' informa quantos bytes de
+        // objetos já destruídos continuam alocados apenas por causa de
+        // 'std::weak_ptr':
+        cout << endl;
+        using Big = std::array<double, 4096>;  // 32 KiB armazenados inline.
+
+        auto sp1 = make_shared_tracked<Big>();
+        std::weak_ptr<Big> wp1{sp1};
+        sp1.reset();
+        cout << "auto sp1 = make_shared_tracked<Big>(); wp1 = sp1; sp1.reset();"
+             << endl;
+        cout << "weak_retained_bytes(): " << weak_retained_bytes() << endl;
+
+        // Com 'make_shared_weak_aware', objetos a partir de um certo tamanho
+        // são alocados separadamente do 'control block' e são devolvidos
+        // assim que o último 'std::shared_ptr' deixa de existir:
+        auto sp2 = make_shared_weak_aware<Big>();
+        std::weak_ptr<Big> wp2{sp2};
+        sp2.reset();
+        cout << "auto sp2 = make_shared_weak_aware<Big>(); wp2 = sp2; "
+                "sp2.reset();"
+             << endl;
+        cout << "weak_retained_bytes(): " << weak_retained_bytes() << endl;
+
+        // Objetos pequenos continuam com a alocação única:
+        auto spv = make_shared_weak_aware<std::vector<int>>(1'000'000, 42);
+        std::weak_ptr<std::vector<int>> wpv{spv};
+        spv.reset();
+        cout << "auto spv = make_shared_weak_aware<std::vector<int>>("
+                "1'000'000, 42); wpv = spv; spv.reset();"
+             << endl;
+        cout << "weak_retained_bytes(): " << weak_retained_bytes()
+             << " (apenas 'sizeof(std::vector<int>)' a mais; os elementos já "
+                "foram liberados pelo destrutor)"
+             << endl;
+
+        wp1.reset();
+        wpv.reset();
+        cout << "wp1.reset(); wpv.reset();" << endl;
+        cout << "weak_retained_bytes(): " << weak_retained_bytes() << endl;
+    }
 };
 }  // namespace item_21
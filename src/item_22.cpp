@@ -9,6 +9,8 @@
 #include <unordered_map>
 #include <vector>
 
+#include "bench.hpp"
+#include "item_22_FastWidget.hpp"
 #include "item_22_Widget.hpp"
 
 namespace item_22 {
@@ -69,5 +71,46 @@ void main() {
         //      << endl;  // erro: segfault. tentativa de acessar recurso que já
         //                // foi previamente movido para outro nome.
     };
+    // A desvantagem do 'Pimpl' com 'std::unique_ptr' é que toda construção e
+    // cópia realiza uma alocação na 'heap', além de toda chamada de método
+    // precisar seguir o ponteiro 'pImpl'. A variante 'FastWidget'
+    // (./item_22_FastWidget.hpp) reserva espaço para o 'Impl' dentro do
+    // próprio objeto, mantendo o 'firewall' de compilação:
+    {
+        cout << endl;
+        cout << "sizeof(Widget): " << sizeof(Widget) << endl;
+        cout << "sizeof(FastWidget): " << sizeof(FastWidget) << endl;
+
+        constexpr int n = 1'000'000;
+        auto measure = [&]<typename W>(std::type_identity<W>,
+                                       const char* nome) {
+            vector<W> src;
+            src.reserve(n);
+            auto t_ctor = time_ms([&] {
+                for (int i = 0; i < n; ++i) src.emplace_back("Widget");
+            });
+            vector<W> copies;
+            copies.reserve(n);
+            auto t_copy = time_ms([&] {
+                for (auto& w : src) copies.emplace_back(w);
+            });
+            vector<W> moved;
+            moved.reserve(n);
+            auto t_move = time_ms([&] {
+                for (auto& w : copies) moved.emplace_back(std::move(w));
+            });
+            std::println(
+                "{}: ctor: {:.2f} ms | copy: {:.2f} ms | move: {:.2f} ms",
+                nome, t_ctor, t_copy, t_move);
+        };
+        measure(std::type_identity<Widget>{}, "Widget    ");
+        measure(std::type_identity<FastWidget>{}, "FastWidget");
+
+        FastWidget fw{"lakdsfj"};
+        FastWidget fw2{fw};  // copy constructor (sem alocação do 'Impl').
+        FastWidget fw3{std::move(fw)};  // move constructor
+        cout << fw2.get_name() << endl;
+        cout << fw3.get_name() << endl;
+    };
 };
 }  // namespace item_22
@@ -0,0 +1,53 @@
+#include "item_22_FastWidget.hpp"
+
+#include <memory>
+#include <new>
+#include <vector>
+using std::vector;
+
+// Definição do tipo 'Impl', idêntica à de 'Widget':
+struct FastWidget::Impl {
+    string name;
+    vector<double> data;
+};
+
+FastWidget::Impl& FastWidget::impl() noexcept {
+    return *std::launder(reinterpret_cast<Impl*>(storage));
+}
+const FastWidget::Impl& FastWidget::impl() const noexcept {
+    return *std::launder(reinterpret_cast<const Impl*>(storage));
+}
+
+// O 'Impl' é construído diretamente no 'buffer' interno por meio de
+// 'placement new' e, portanto, deve ser destruído explicitamente:
+FastWidget::FastWidget(string name) {
+    // Apenas aqui o tipo 'Impl' está completo, sendo possível verificar se o
+    // 'buffer' reservado na declaração de 'FastWidget' é suficiente:
+    static_assert(sizeof(Impl) <= impl_size,
+                  "'FastWidget::impl_size' é menor que 'sizeof(Impl)'.");
+    static_assert(impl_align % alignof(Impl) == 0,
+                  "'FastWidget::impl_align' não satisfaz 'alignof(Impl)'.");
+    ::new (static_cast<void*>(storage)) Impl{std::move(name), {}};
+}
+FastWidget::~FastWidget() { std::destroy_at(&impl()); }
+
+FastWidget::FastWidget(const FastWidget& other) {
+    ::new (static_cast<void*>(storage)) Impl(other.impl());
+}
+FastWidget& FastWidget::operator=(const FastWidget& other) {
+    impl() = other.impl();
+    return *this;
+}
+
+// Diferentemente de 'Widget', não há ponteiro a ser transferido: o 'Impl' é
+// movimentado membro a membro. O objeto de origem permanece num estado válido
+// (com 'Impl' movimentado), e não mais com um ponteiro nulo.
+FastWidget::FastWidget(FastWidget&& other) noexcept {
+    ::new (static_cast<void*>(storage)) Impl(std::move(other.impl()));
+}
+FastWidget& FastWidget::operator=(FastWidget&& other) noexcept {
+    impl() = std::move(other.impl());
+    return *this;
+}
+
+string FastWidget::get_name() { return impl().name; }
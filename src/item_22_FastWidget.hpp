@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+using std::string;
+
+// Variante de 'Widget' (./item_22_Widget.hpp) que implementa o padrão 'Fast
+// Pimpl': ao invés de manter um 'std::unique_ptr<Impl>', o objeto reserva
+// internamente um 'buffer' com tamanho e alinhamento suficientes para
+// armazenar o 'Impl'. Desta forma não há alocação na 'heap' a cada construção
+// ou cópia, nem a indireção de ponteiro a cada acesso.
+//
+// O 'firewall' de compilação é mantido: a definição de 'Impl' continua
+// existindo apenas no arquivo fonte (./item_22_FastWidget.cpp), que verifica
+// por meio de 'static_assert' se as constantes abaixo continuam válidas.
+class FastWidget {
+   public:
+    FastWidget(string nome);
+    ~FastWidget();
+
+    // copy constructor
+    FastWidget(const FastWidget& other);
+    // copy assignment
+    FastWidget& operator=(const FastWidget& other);
+
+    // move constructor
+    FastWidget(FastWidget&& other) noexcept;
+    // move assignment
+    FastWidget& operator=(FastWidget&& other) noexcept;
+
+    string get_name();
+
+   private:
+    struct Impl;
+
+    // Tamanho e alinhamento de 'Impl' ('std::string' + 'std::vector<double>').
+    // Caso 'Impl' seja alterado, a compilação do arquivo fonte falhará até que
+    // estes valores sejam atualizados.
+    static constexpr std::size_t impl_size = 56;
+    static constexpr std::size_t impl_align = 8;
+
+    Impl& impl() noexcept;
+    const Impl& impl() const noexcept;
+
+    alignas(impl_align) std::byte storage[impl_size];
+};
@@ -1,14 +1,21 @@
+#include <bit>
 #include <boost/type_index.hpp>
+#include <cstddef>
+#include <cstring>
 #include <functional>
 #include <iostream>
 #include <list>
 #include <memory>
 #include <print>
 #include <ranges>
+#include <string>
+#include <string_view>
 #include <type_traits>
 #include <unordered_map>
 #include <vector>
 
+#include "bench.hpp"
+
 namespace item_23 {
 using boost::typeindex::type_id_with_cvr;
 using std::cout;
@@ -54,23 +61,122 @@ decltype(auto) move2(T&& param) {
         param);  // 'cast' incondicional de 'param' para um tipo 'T&&'.
 }
 
+// 'String' compacto de 24 bytes: 'strings' de até 23 caracteres são
+// armazenadas no próprio objeto ('small string optimization'), e 'strings'
+// maiores em um 'buffer' alocado na 'heap'.
+//
+// No modo interno, o último byte guarda '23 - size()', de forma que uma
+// 'string' de 23 caracteres tenha o byte nulo terminador exatamente nessa
+// posição. No modo 'heap', o mesmo byte é o mais significativo de 'cap' (em
+// arquiteturas 'little-endian'), que é marcado com o bit mais alto.
+//
+// Os contadores estáticos existem apenas para as demonstrações abaixo.
 class String {
    public:
-    // ...
-    String() = default;
-    String(const String&) { cout << "copy constructor!"; };  // copy ctor
-    String(String&&) { cout << "move constructor!"; };       // move ctor
-    // ...
-};  // namespace item_23
+    static inline long copy_count{0};
+    static inline long move_count{0};
+
+    String() { set_inline_size(0); }
+    String(const char* s) : String(std::string_view{s}) {}
+    String(std::string_view s) { init(s.data(), s.size()); }
+
+    String(const String& other) {  // copy ctor
+        ++copy_count;
+        init(other.data(), other.size());
+    };
+    String(String&& other) noexcept {  // move ctor
+        ++move_count;
+        std::memcpy(&rep, &other.rep, sizeof(rep));
+        other.set_inline_size(0);
+    };
+    String& operator=(const String& other) {
+        if (this != &other) {
+            ++copy_count;
+            // A nova representação é construída antes da liberação da atual,
+            // de forma que uma exceção em 'new' preserve '*this'.
+            String tmp{std::string_view{other}};
+            release();
+            std::memcpy(&rep, &tmp.rep, sizeof(rep));
+            tmp.set_inline_size(0);
+        }
+        return *this;
+    }
+    String& operator=(String&& other) noexcept {
+        if (this != &other) {
+            ++move_count;
+            release();
+            std::memcpy(&rep, &other.rep, sizeof(rep));
+            other.set_inline_size(0);
+        }
+        return *this;
+    }
+    ~String() { release(); }
+
+    std::size_t size() const {
+        return is_heap() ? rep.heap.size : inline_capacity - inline_tag();
+    }
+    const char* data() const { return is_heap() ? rep.heap.ptr : rep.buf; }
+    const char* c_str() const { return data(); }
+    bool is_inline() const { return !is_heap(); }
+    operator std::string_view() const { return {data(), size()}; }
+
+    friend bool operator==(const String& a, const String& b) {
+        return std::string_view{a} == std::string_view{b};
+    }
+
+   private:
+    static constexpr std::size_t inline_capacity = 23;
+    static constexpr std::size_t heap_flag = std::size_t{1} << 63;
+
+    unsigned char inline_tag() const {
+        return static_cast<unsigned char>(rep.buf[inline_capacity]);
+    }
+    bool is_heap() const { return inline_tag() & 0x80; }
+
+    void set_inline_size(std::size_t n) {
+        rep.buf[n] = '\0';
+        rep.buf[inline_capacity] = static_cast<char>(inline_capacity - n);
+    }
+
+    void init(const char* s, std::size_t n) {
+        if (n <= inline_capacity) {
+            std::memcpy(rep.buf, s, n);
+            set_inline_size(n);
+        } else {
+            char* p = new char[n + 1];
+            std::memcpy(p, s, n);
+            p[n] = '\0';
+            rep.heap = {p, n, n | heap_flag};
+        }
+    }
+
+    void release() {
+        if (is_heap()) delete[] rep.heap.ptr;
+    }
+
+    union Rep {
+        struct Heap {
+            char* ptr;
+            std::size_t size;
+            std::size_t cap;  // bit mais alto: indicador do modo 'heap'.
+        } heap;
+        char buf[inline_capacity + 1];
+    } rep;
+};
+static_assert(sizeof(String) == 24);
+static_assert(std::endian::native == std::endian::little,
+              "O indicador de modo 'heap' de 'String' assume 'little-endian'.");
 
 // Entretanto, deve-se ter cuidado no momento de realizar as operações de
 // 'std::move', pois em determinados contextos é possível obter resultados
 // diferentes do esperado:
 class Annotation {
    public:
-    // No caso deste construtor, a operação que será realizada de fato é uma
-    // operação de cópia.
-    explicit Annotation(const String& text) : value(std::move(text)) {}
+    // Um construtor definido como:
+    //
+    // explicit Annotation(const String& text) : value(std::move(text)) {}
+    //
+    // realiza de fato uma operação de cópia.
     // Este construtor tenta inicializar o atributo 'value' por meio de uma
     // operação de movimentação sobre o objeto 'text'. Entretanto o argumento
     // 'text' é definido como um 'const lvalue'. Mesmo com a tentativa de
@@ -92,6 +198,11 @@ class Annotation {
     // explicit Annotation(String& text) : value(std::move(text)) {}
     // ou:
     // explicit Annotation(String&& text) : value(std::move(text)) {}
+    //
+    // Ou ainda, receber o argumento por valor e movê-lo para o atributo: para
+    // 'rvalues' há apenas movimentações, e para 'lvalues' uma única cópia (na
+    // construção do parâmetro 'text'):
+    explicit Annotation(String text) : value(std::move(text)) {}
 
    private:
     String value;
@@ -100,12 +211,68 @@ class Annotation {
 // operações de movimentação num objeto, então não se deve qualificar o mesmo
 // como 'const'.
 
+// Versões genéricas das duas formas de construtor, utilizadas na comparação de
+// desempenho entre 'String' e 'std::string':
+template <typename S>
+class ConstRefAnnotation {
+   public:
+    explicit ConstRefAnnotation(const S& text)
+        : value(std::move(text)) {}  // cópia!
+    S value;
+};
+
+template <typename S>
+class ByValueAnnotation {
+   public:
+    explicit ByValueAnnotation(S text) : value(std::move(text)) {}
+    S value;
+};
+
 template <typename T>
     requires std::is_base_of_v<String, std::remove_reference_t<T>>
 auto dispatch_args_to_String(T&& arg) {
     return std::forward<T>(arg);
 }
 
+// Registra os contadores de 'String' na sua construção; '.print()' imprime as
+// cópias e movimentações realizadas desde então.
+struct StringOps {
+    long copies{String::copy_count};
+    long moves{String::move_count};
+    void print() const {
+        for (long i = copies; i < String::copy_count; ++i)
+            cout << "copy constructor!";
+        for (long i = moves; i < String::move_count; ++i)
+            cout << "move constructor!";
+    }
+};
+
+// Comparação entre 'String' e 'std::string' na construção de anotações, para
+// textos curtos (internos em ambos), de 20 caracteres (internos apenas em
+// 'String', já que 'std::string' da libstdc++ armazena até 15 caracteres no
+// próprio objeto) e longos (na 'heap' em ambos). A armadilha do 'const&'
+// transforma a movimentação numa cópia, o que para textos na 'heap' implica
+// uma alocação adicional.
+template <typename S>
+void bench_annotation(const char* label, std::string_view text) {
+    constexpr int n = 1'000'000;
+    auto by_value = time_ms([&] {
+        for (int i = 0; i < n; ++i) {
+            ByValueAnnotation<S> a{S{text}};
+            do_not_optimize(a);
+        }
+    });
+    auto const_ref = time_ms([&] {
+        for (int i = 0; i < n; ++i) {
+            ConstRefAnnotation<S> a{S{text}};
+            do_not_optimize(a);
+        }
+    });
+    std::println("{:<12} {:>3} chars  por valor: {:7.2f} ms  "
+                 "const&: {:7.2f} ms",
+                 label, text.size(), by_value, const_ref);
+}
+
 void main() {
     // Apesar do nome, 'std::move' é basicamente uma função template que realiza
     // um 'cast' incondicional para um tipo 'rvalue'. Desta forma, abrindo a
@@ -114,7 +281,9 @@ void main() {
     {
         cout << endl;
         cout << "Annotation annot{String{}}: ";
+        StringOps ops{};
         Annotation annot{String{}};
+        ops.print();
         cout << endl;
     };
     {
@@ -122,8 +291,43 @@ void main() {
         cout << "String texto{};" << endl;
         String texto{};
         cout << "Annotation annot{texto}: ";
+        StringOps ops{};
         Annotation annot{texto};
+        ops.print();
+        cout << endl;
+    };
+    {
+        cout << endl;
+        cout << "ConstRefAnnotation<String> annot{String{}}: ";
+        StringOps ops{};
+        ConstRefAnnotation<String> annot{String{}};
+        ops.print();
+        cout << endl;
+    };
+    {
+        cout << endl;
+        String curta{"texto curto"};
+        String longa{"um texto longo o bastante para ir para a heap"};
+        std::println("sizeof(String): {}, sizeof(std::string): {}",
+                     sizeof(String), sizeof(std::string));
+        std::println("'{}': interna? {}", std::string_view{curta},
+                     curta.is_inline());
+        std::println("'{}': interna? {}", std::string_view{longa},
+                     longa.is_inline());
+        String movida{std::move(longa)};
+        std::println("após movimentação: '{}' e '{}'",
+                     std::string_view{movida}, std::string_view{longa});
+    };
+    {
         cout << endl;
+        std::string_view curto{"texto curto"};
+        std::string_view medio{"vinte caracteres!..."};
+        std::string_view longo{
+            "um texto longo o bastante para ir para a heap em ambos os tipos"};
+        for (auto text : {curto, medio, longo}) {
+            bench_annotation<String>("String", text);
+            bench_annotation<std::string>("std::string", text);
+        }
     };
 
     // Análogamente à função 'std::move', 'std::forward<T>' também é uma função
@@ -139,7 +343,9 @@ void main() {
     {
         cout << endl;
         cout << "dispatch_args_to_String(String{}): ";
+        StringOps ops{};
         dispatch_args_to_String(String{});
+        ops.print();
         cout << endl;
     };
     {
@@ -147,7 +353,9 @@ void main() {
         cout << "String texto{};" << endl;
         cout << "dispatch_args_to_String(texto): ";
         String texto{};
+        StringOps ops{};
         dispatch_args_to_String(texto);
+        ops.print();
         cout << endl;
     }
 };
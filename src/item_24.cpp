@@ -1,14 +1,23 @@
+#include <algorithm>
 #include <boost/type_index.hpp>
+#include <cstddef>
+#include <cstdlib>
 #include <functional>
 #include <iostream>
 #include <list>
 #include <memory>
+#include <new>
 #include <print>
 #include <ranges>
+#include <ratio>
 #include <type_traits>
 #include <unordered_map>
 #include <vector>
 
+#include "bench.hpp"
+#include "function_ref.hpp"
+#include "trivially_relocatable.hpp"
+
 namespace item_24 {
 using boost::typeindex::type_id_with_cvr;
 using std::cout;
@@ -62,20 +71,163 @@ void f3(const T&& param) {
 };  // É 'rvalue ref'. A presença de 'const' já é o suficiente para inibir o
     // mecanismo de dedução de tipo.
 
-template <class T>
+// Versão não 'template' de 'g' (ver 'main'), para funções com a assinatura
+// 'void(Widget&&)'. 'function_ref' (./function_ref.hpp) aceita qualquer
+// invocável compatível sem gerar novas instanciações e sem alocar memória:
+void g_ref(function_ref<void(Widget&&)> func, Widget&& w) {
+    func(std::move(w));
+}
+
+// Funções de ordem superior para a comparação da passagem de 'callbacks' por
+// 'std::function', por 'function_ref' e por 'template'. 'noinline' para que a
+// chamada não seja eliminada pelo compilador.
+[[gnu::noinline]] double sum_function(const std::function<double(int)>& func,
+                                      int n) {
+    double total = 0;
+    for (int i = 0; i < n; ++i) total += func(i);
+    return total;
+}
+[[gnu::noinline]] double sum_ref(function_ref<double(int)> func, int n) {
+    double total = 0;
+    for (int i = 0; i < n; ++i) total += func(i);
+    return total;
+}
+template <typename Func>
+[[gnu::noinline]] double sum_template(Func&& func, int n) {
+    double total = 0;
+    for (int i = 0; i < n; ++i) total += func(i);
+    return total;
+}
+
+// Container contíguo mínimo, com fator de crescimento configurável ('Growth').
+// Ao crescer, os elementos são realocados por 'std::move_if_noexcept' (para
+// manter a garantia forte de exceção) ou, para tipos trivialmente realocáveis
+// (./trivially_relocatable.hpp), por meio de um único 'std::realloc'.
+template <class T, class Growth = std::ratio<2>>
 class Vector {
+    static_assert(std::ratio_greater_v<Growth, std::ratio<1>>,
+                  "O fator de crescimento deve ser maior que 1.");
+    static_assert(alignof(T) <= alignof(std::max_align_t));
+
    public:
     Vector() {};
-    void push_back(T&&) {
+    Vector(const Vector& other) {
+        reserve(other.size_);
+        // Como o destrutor não é executado quando o construtor emite uma
+        // exceção, o 'buffer' precisa ser liberado aqui.
+        try {
+            std::uninitialized_copy_n(other.data_, other.size_, data_);
+        } catch (...) {
+            std::free(data_);
+            throw;
+        }
+        size_ = other.size_;
+    }
+    Vector(Vector&& other) noexcept
+        : data_{std::exchange(other.data_, nullptr)},
+          size_{std::exchange(other.size_, 0)},
+          capacity_{std::exchange(other.capacity_, 0)} {}
+    Vector& operator=(Vector other) noexcept {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
+        return *this;
+    }
+    ~Vector() {
+        clear();
+        std::free(data_);
+    }
+
+    void push_back(T&& value) {
+        emplace_back(std::move(value));
     };  // É 'rvalue ref', já que não há a presença do mecanismo de type
         // deduction para o método 'push_back' específicamente.
     template <class... Args>
-    void emplace_back(Args&&... args) {
+    T& emplace_back(Args&&... args) {
+        if (size_ == capacity_) {
+            // 'args' pode referenciar um elemento do próprio vetor, que
+            // deixaria de ser válido após a realocação:
+            T tmp(std::forward<Args>(args)...);
+            grow(size_ + 1);
+            std::construct_at(data_ + size_, std::move(tmp));
+        } else {
+            std::construct_at(data_ + size_, std::forward<Args>(args)...);
+        }
+        return data_[size_++];
     };  // É 'universal ref', já que se trata de um método template, com a
         // presença do mecanismo de dedução de tipo. Os tipos dos parãmetros
         // 'args' são independentes do tipo 'T' da classe 'Vector<T>'. Todo
         // processo de invocação do método 'emplace_back' resulta na necessidade
         // de se deduzir o tipo dos argumentos 'args'.
+
+    void pop_back() { std::destroy_at(data_ + --size_); }
+    void clear() {
+        std::destroy_n(data_, size_);
+        size_ = 0;
+    }
+    void reserve(std::size_t n) {
+        if (n > capacity_) relocate(n);
+    }
+
+    std::size_t size() const { return size_; }
+    std::size_t capacity() const { return capacity_; }
+    bool empty() const { return size_ == 0; }
+    T* data() { return data_; }
+    T& operator[](std::size_t i) { return data_[i]; }
+    const T& operator[](std::size_t i) const { return data_[i]; }
+    T* begin() { return data_; }
+    T* end() { return data_ + size_; }
+    const T* begin() const { return data_; }
+    const T* end() const { return data_ + size_; }
+
+   private:
+    void grow(std::size_t min_capacity) {
+        auto next = capacity_ * Growth::num / Growth::den;
+        relocate(std::max({next, min_capacity, std::size_t{4}}));
+    }
+
+    void relocate(std::size_t n) {
+        if constexpr (is_trivially_relocatable_v<T>) {
+            // Os bytes dos elementos são transferidos pelo próprio 'realloc',
+            // que muitas vezes consegue expandir o bloco sem copiá-lo.
+            void* p = std::realloc(data_, n * sizeof(T));
+            if (!p) throw std::bad_alloc{};
+            data_ = static_cast<T*>(p);
+        } else {
+            T* p = static_cast<T*>(std::malloc(n * sizeof(T)));
+            if (!p) throw std::bad_alloc{};
+            if constexpr (std::is_nothrow_move_constructible_v<T>) {
+                // Sem possibilidade de exceção, cada elemento é movido e
+                // destruído numa única passada sobre o 'buffer' antigo.
+                for (std::size_t i = 0; i < size_; ++i) {
+                    std::construct_at(p + i, std::move(data_[i]));
+                    std::destroy_at(data_ + i);
+                }
+                std::free(data_);
+                data_ = p;
+                capacity_ = n;
+                return;
+            }
+            std::size_t i = 0;
+            try {
+                for (; i < size_; ++i) {
+                    std::construct_at(p + i, std::move_if_noexcept(data_[i]));
+                }
+            } catch (...) {
+                std::destroy_n(p, i);
+                std::free(p);
+                throw;
+            }
+            std::destroy_n(data_, size_);
+            std::free(data_);
+            data_ = p;
+        }
+        capacity_ = n;
+    }
+
+    T* data_{nullptr};
+    std::size_t size_{0};
+    std::size_t capacity_{0};
 };
 
 void main() {
@@ -143,6 +295,44 @@ void main() {
         // vw.push_back(w);  // erro: rvalue reference to type 'item_24::Widget'
         //                   // cannot bind to lvalue of type 'Widget'
         vw.push_back(std::move(w));
+        // Para 'lvalues', a inserção deve ser feita por 'emplace_back', que
+        // recebe referências universais e realiza a cópia:
+        vw.emplace_back(w);
+        cout << "vw.size(): " << vw.size() << endl;
+    };
+    {
+        // Comparação do crescimento de 'Vector<T>' contra 'std::vector<T>'.
+        // 'std::string' (na 'libstdc++') não é trivialmente realocável e usa
+        // o caminho com 'std::move_if_noexcept'; já 'std::unique_ptr' é
+        // realocado com 'std::realloc':
+        cout << endl;
+        constexpr int n = 1'000'000;
+        // O melhor tempo dentre algumas repetições, para reduzir a influência
+        // do estado do alocador deixado pelas medições anteriores.
+        auto bench = [&]<typename V>(std::type_identity<V>, auto make,
+                                     const char* nome) {
+            double best = 1e300;
+            for (int rep = 0; rep < 3; ++rep) {
+                V v;
+                best = std::min(best, time_ms([&] {
+                    for (int i = 0; i < n; ++i) v.emplace_back(make(i));
+                }));
+                do_not_optimize(v.data());
+            }
+            std::println("{}: {:.2f} ms", nome, best);
+        };
+        auto make_str = [](int i) { return string(32, 'a' + i % 26); };
+        auto make_up = [](int i) { return mu<int>(i); };
+        bench(std::type_identity<vector<string>>{}, make_str,
+              "std::vector<string>     ");
+        bench(std::type_identity<Vector<string>>{}, make_str,
+              "Vector<string>          ");
+        bench(std::type_identity<vector<up<int>>>{}, make_up,
+              "std::vector<up<int>>    ");
+        bench(std::type_identity<Vector<up<int>>>{}, make_up,
+              "Vector<up<int>>         ");
+        bench(std::type_identity<Vector<up<int>, std::ratio<3, 2>>>{}, make_up,
+              "Vector<up<int>, 3/2>    ");
     };
     {
         // Ainda, é possível definir funções lambda com referências universais:
@@ -165,5 +355,44 @@ void main() {
         cout << "g(f3<Widget>, std::move(w)): ";
         g(f3<Widget>, std::move(w));
     };
+    {
+        // Com uma assinatura fixa, a função de ordem superior não precisa ser
+        // 'template' ('g_ref'):
+        cout << endl;
+        cout << "g_ref(f3<Widget>, Widget{}): ";
+        g_ref(f3<Widget>, Widget{});
+        cout << "g_ref([](Widget&& w) { f(std::move(w)); }, Widget{}): ";
+        g_ref([](Widget&& w) { f(std::move(w)); }, Widget{});
+    };
+    {
+        // Custo de 1'000'000 de chamadas a funções de ordem superior, cada uma
+        // invocando 8 vezes uma 'lambda' com 24 bytes de capturas (que não
+        // cabem no 'buffer' interno de 'std::function', levando a uma
+        // alocação por chamada):
+        cout << endl;
+        constexpr int calls = 1'000'000;
+        constexpr int n = 8;
+        double a = 1.0, b = 2.0, c = 3.0;
+        auto measure = [&](auto sum) {
+            double total = 0;
+            auto t = time_ms([&] {
+                for (int k = 0; k < calls; ++k) {
+                    total += sum([a, b, c](int i) { return a * i + b - c; });
+                    do_not_optimize(a);
+                }
+            });
+            do_not_optimize(total);
+            return t;
+        };
+        auto t_function = measure([](auto&& func) {
+            return sum_function(std::forward<decltype(func)>(func), n);
+        });
+        auto t_ref = measure([](auto&& func) { return sum_ref(func, n); });
+        auto t_template =
+            measure([](auto&& func) { return sum_template(func, n); });
+        std::println("std::function: {:.2f} ms", t_function);
+        std::println("function_ref:  {:.2f} ms", t_ref);
+        std::println("template:      {:.2f} ms", t_template);
+    };
 };
 }  // namespace item_24
@@ -1,16 +1,28 @@
+#include <algorithm>
 #include <boost/type_index.hpp>
 #include <chrono>
+#include <concepts>
 #include <functional>
 #include <iostream>
 #include <list>
 #include <memory>
+#include <mutex>
 #include <print>
 #include <ranges>
+#include <streambuf>
+#include <string_view>
+#include <thread>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "async_logger.hpp"
+#include "bench.hpp"
+#include "intern_table.hpp"
+#include "snapshot.hpp"
+#include "timestamp.hpp"
+
 namespace item_26 {
 using boost::typeindex::type_id_with_cvr;
 using std::cout;
@@ -45,39 +57,119 @@ auto stringify(Rng&& seq) {
     return "{" + std::string(std::begin(b), std::end(b)) + "}";
 };
 
-vector<string> names{};
-
+// Os nomes registrados são armazenados como símbolos de uma tabela de
+// 'interning' (./intern_table.hpp): cada nome distinto é guardado uma única
+// vez e 'names' contém apenas identificadores de 32 bits. As discussões sobre
+// cópias e movimentações para dentro de 'names' referem-se à versão original,
+// com 'std::string', na qual o argumento era de fato copiado ou movido:
+// vector<string> names{};
+intern_table name_symbols;
+vector<intern_table::symbol> names{};
+
+// Os 'timestamps' são obtidos de 'tsc_clock' (./timestamp.hpp), bem mais
+// barato que 'std::chrono::system_clock::now()', e convertidos para
+// 'system_clock' apenas para formatação.
 void log_and_add_1(const string& name) {  // (1)
-    auto now = std::chrono::system_clock::now();
+    auto now = tsc_clock::to_sys(tsc_clock::now());
     cout << std::format("name: {} | time: {}", name, now) << endl;
-    names.emplace_back(name);
+    names.emplace_back(name_symbols.intern(name));
 }
 
 template <typename T>  // (2)
 void log_and_add_2(T&& name) {
     // cout << type_id_with_cvr<decltype(name)>().pretty_name() << endl;
-    auto now = std::chrono::system_clock::now();
+    auto now = tsc_clock::to_sys(tsc_clock::now());
     cout << std::format("name: {} | time: {}", name, now) << endl;
-    names.emplace_back(std::forward<T>(name));
+    names.emplace_back(name_symbols.intern(std::forward<T>(name)));
 }
 
 template <typename T>  // (2)
 void log_and_add_3(T&& name) {
     // cout << type_id_with_cvr<decltype(name)>().pretty_name() << endl;
-    auto now = std::chrono::system_clock::now();
+    auto now = tsc_clock::to_sys(tsc_clock::now());
     cout << std::format("name: {} | time: {}", name, now) << endl;
-    names.emplace_back(std::forward<T>(name));
+    names.emplace_back(name_symbols.intern(std::forward<T>(name)));
 }
 
-vector<string> name_from_idx{
+// Tabela global de consulta, lida com muito mais frequência do que alterada.
+// Os leitores obtêm um 'snapshot' imutável sem a necessidade de 'locks'
+// (ver './snapshot.hpp').
+snapshot<vector<string>> name_from_idx{
     "Dante",
     "Vergil",
     "Nero",
 };
 void log_and_add_3(int idx) {
-    auto now = std::chrono::system_clock::now();
-    cout << std::format("name: {} | time: {}", name_from_idx[idx], now) << endl;
-    names.emplace_back(name_from_idx[idx]);
+    auto now = tsc_clock::to_sys(tsc_clock::now());
+    auto table = name_from_idx.load();
+    cout << std::format("name: {} | time: {}", (*table)[idx], now) << endl;
+    names.emplace_back(name_symbols.intern((*table)[idx]));
+}
+
+// Registro em lote: para importações grandes, ler o relógio, imprimir e
+// possivelmente realocar 'names' a cada nome domina o custo. As sobrecargas
+// abaixo aceitam qualquer 'range' de nomes ('std::string', 'std::string_view',
+// 'const char*', ...) ou de índices de 'name_from_idx', reservando espaço uma
+// única vez e registrando uma única linha (e um único 'timestamp') por lote.
+//
+// Como 'log_and_add_2' e 'log_and_add_3' são templates com referência
+// universal, as sobrecargas para 'ranges' precisam ser restringidas: entre
+// duas templates igualmente viáveis, a mais restrita é a escolhida. 'strings'
+// (que também são 'ranges' de caracteres) são excluídas explicitamente.
+template <typename R>
+concept NameBatch =
+    rg::input_range<R> && !std::convertible_to<R, std::string_view> &&
+    (std::convertible_to<rg::range_reference_t<R>, std::string_view> ||
+     std::integral<rg::range_value_t<R>>);
+
+template <NameBatch R>
+void log_and_add_batch(R&& batch) {
+    auto now = tsc_clock::to_sys(tsc_clock::now());
+    if constexpr (rg::sized_range<R>) {
+        // Mantém o crescimento geométrico mesmo com vários lotes pequenos.
+        auto needed = names.size() + rg::size(batch);
+        if (needed > names.capacity()) {
+            names.reserve(std::max(needed, 2 * names.capacity()));
+        }
+    }
+    auto before = names.size();
+    if constexpr (std::integral<rg::range_value_t<R>>) {
+        auto table = name_from_idx.load();
+        for (auto idx : batch) {
+            names.emplace_back(name_symbols.intern((*table)[idx]));
+        }
+    } else {
+        for (auto&& name : batch) {
+            names.emplace_back(name_symbols.intern(name));
+        }
+    }
+    cout << std::format("batch: {} names | time: {}", names.size() - before,
+                        now)
+         << endl;
+}
+
+template <NameBatch R>
+void log_and_add_1(R&& batch) {
+    log_and_add_batch(std::forward<R>(batch));
+}
+
+template <NameBatch R>
+void log_and_add_2(R&& batch) {
+    log_and_add_batch(std::forward<R>(batch));
+}
+
+template <NameBatch R>
+void log_and_add_3(R&& batch) {
+    log_and_add_batch(std::forward<R>(batch));
+}
+
+// Versão que emite para um 'async_logger' (./async_logger.hpp): a 'thread'
+// chamadora apenas copia o nome e o 'timestamp' cru para um registro binário,
+// e a formatação e a escrita ocorrem numa 'thread' de fundo.
+template <typename T>
+void log_and_add_4(async_logger& logger, T&& name) {
+    logger.log("name: {}", name);
+    names.emplace_back(name_symbols.intern(std::forward<T>(name)));
 }
 
 class Foo {
@@ -87,7 +179,7 @@ class Foo {
         cout << "universal reference constructor" << endl;
     };
 
-    Foo(int idx) : name{name_from_idx[idx]} {
+    Foo(int idx) : name{(*name_from_idx.load())[idx]} {
         cout << "'int' specialized constructor" << endl;
     };
 
@@ -210,6 +302,26 @@ void main() {
         //                 // universal inibe o mecanismo de conversão implícita
         //                 // de tipos ('short' para 'int').
     };
+    {
+        // Versões em lote: a sobrecarga restrita a 'ranges' tem preferência
+        // sobre a template com referência universal.
+        cout << endl;
+        vector<string> imported{"Lady", "Trish", "Nico"};
+        log_and_add_2(imported);
+        log_and_add_3(std::move(imported));
+        log_and_add_3(vector<int>{0, 1, 2, 1});
+        std::string_view views[]{"Kyrie", "Morrison"};
+        log_and_add_1(views);
+    };
+    {
+        // Registro assíncrono: as mensagens são escritas em 'cout' pela
+        // 'thread' de fundo do 'logger'.
+        cout << endl;
+        async_logger logger{cout};
+        log_and_add_4(logger, string{"Lady"});
+        log_and_add_4(logger, "Trish");
+        logger.flush();
+    };
     // Percebe-se que as funções com argumentos definidos como referências
     // universais são as mais propensas a serem escolhidas para execução.
     // Justamente pelo fato do mecanismo de dedução de tipo conseguir produzir,
@@ -244,5 +356,207 @@ void main() {
     // Construtores com 'perefct-forward' são especialmente problemáticos pois
     // geralmente resultam em melhores 'matches' que 'copy constructors' para
     // 'lvalues' não constantes.
+    {
+        // Comparação da escalabilidade de leitura da tabela 'name_from_idx'
+        // publicada como 'snapshot' contra um 'vector' protegido por
+        // 'std::mutex'. Cada 'thread' realiza 'reads' consultas. '.load()'
+        // ainda disputa o contador de referências do 'control block', enquanto
+        // 'snapshot<T>::reader' apenas lê o contador de versão da tabela,
+        // permitindo que os leitores escalem com o número de 'threads'.
+        cout << endl;
+        constexpr int reads = 1'000'000;
+        vector<string> locked_names{"Dante", "Vergil", "Nero"};
+        std::mutex m;
+
+        // 'make_reader' é invocado uma vez por 'thread' e retorna a função de
+        // leitura utilizada por esta.
+        auto run = [](unsigned n_threads, auto make_reader) {
+            return time_ms([&] {
+                vector<std::jthread> threads;
+                for (unsigned t = 0; t < n_threads; ++t) {
+                    threads.emplace_back([&] {
+                        auto read_one = make_reader();
+                        std::size_t total = 0;
+                        for (int i = 0; i < reads; ++i) {
+                            total += read_one(i % 3);
+                        }
+                        do_not_optimize(total);
+                    });
+                }
+            });
+        };
+
+        for (unsigned n_threads : {1u, 2u, 4u, 8u}) {
+            auto t_load = run(n_threads, [] {
+                return [](int idx) {
+                    return (*name_from_idx.load())[idx].size();
+                };
+            });
+            auto t_reader = run(n_threads, [] {
+                return [r = snapshot<vector<string>>::reader{name_from_idx}](
+                           int idx) mutable { return (*r)[idx].size(); };
+            });
+            auto t_mutex = run(n_threads, [&] {
+                return [&](int idx) {
+                    std::scoped_lock lock{m};
+                    return locked_names[idx].size();
+                };
+            });
+            std::println(
+                "threads: {} | load: {:.2f} ms | reader: {:.2f} ms | mutex: "
+                "{:.2f} ms",
+                n_threads, t_load, t_reader, t_mutex);
+        }
+
+        // Escritas copiam a tabela, a modificam e publicam a nova versão.
+        // Leitores que ainda possuem a versão anterior não são afetados:
+        auto old_table = name_from_idx.load();
+        name_from_idx.update(
+            [](vector<string>& t) { t.emplace_back("Trish"); });
+        cout << "old_table->size(): " << old_table->size() << endl;
+        cout << "name_from_idx.load()->size(): " << name_from_idx.load()->size()
+             << endl;
+
+        // 'T' não precisa ser um container:
+        snapshot<int> generation{5};
+        generation.update([](int& g) { ++g; });
+        cout << "*generation.load(): " << *generation.load() << endl;
+    };
+    {
+        // Custo por chamada das fontes de 'timestamp' (./timestamp.hpp).
+        // '::ticks()' é a leitura crua do contador, a ser convertida apenas
+        // quando necessário.
+        cout << endl;
+        constexpr int n = 10'000'000;
+        // Calibração do TSC e início da 'thread' de 'coarse_clock' fora da
+        // medição:
+        tsc_clock::now();
+        coarse_clock::now();
+        auto per_call = [&](auto read) {
+            return time_ms([&] {
+                       for (int i = 0; i < n; ++i) do_not_optimize(read());
+                   }) *
+                   1e6 / n;
+        };
+        auto t_sys = per_call([] { return std::chrono::system_clock::now(); });
+        auto t_ticks = per_call([] { return tsc_clock::ticks(); });
+        auto t_tsc = per_call([] { return tsc_clock::now(); });
+        auto t_coarse = per_call([] { return coarse_clock::now(); });
+        std::println("system_clock::now(): {:.2f} ns", t_sys);
+        std::println("tsc_clock::ticks():  {:.2f} ns", t_ticks);
+        std::println("tsc_clock::now():    {:.2f} ns", t_tsc);
+        std::println("coarse_clock::now(): {:.2f} ns", t_coarse);
+        std::println("frequência do TSC: {:.3f} GHz",
+                     tsc_clock::frequency() / 1e9);
+
+        auto sys = std::chrono::system_clock::now();
+        auto tsc = tsc_clock::to_sys(tsc_clock::now());
+        auto coarse = coarse_clock::to_sys(coarse_clock::now());
+        cout << std::format("system_clock: {}\ntsc_clock:    {}\n"
+                            "coarse_clock: {}",
+                            sys, tsc, coarse)
+             << endl;
+    };
+    {
+        // Importação de 1'000'000 de nomes: chamadas individuais contra uma
+        // única chamada em lote. A saída é descartada durante a medição para
+        // que apenas o custo de formatação (e não o do terminal) seja
+        // contabilizado.
+        cout << endl;
+        constexpr int n = 1'000'000;
+        auto table = name_from_idx.load();
+        vector<string> incoming;
+        incoming.reserve(n);
+        for (int i = 0; i < n; ++i) {
+            incoming.emplace_back((*table)[i % table->size()]);
+        }
+
+        struct null_buffer : std::streambuf {
+            int overflow(int c) override { return c; }
+        } discard;
+        auto* original = cout.rdbuf(&discard);
+        names.clear();
+        names.shrink_to_fit();
+        auto t_single = time_ms([&] {
+            for (const auto& name : incoming) log_and_add_1(name);
+        });
+        names.clear();
+        names.shrink_to_fit();
+        auto t_batch = time_ms([&] { log_and_add_1(incoming); });
+        cout.rdbuf(original);
+        std::println("individual: {:.2f} ms | lote: {:.2f} ms ({:.1f}x)",
+                     t_single, t_batch, t_single / t_batch);
+
+        // 'async_logger': custo por registro na 'thread' chamadora, com um
+        // 'buffer' grande o suficiente para o lote inteiro, e custo total (até
+        // que todos os registros tenham sido formatados e escritos). Com mais
+        // de um núcleo, a formatação ocorre em paralelo às chamadas.
+        constexpr std::size_t burst = 1 << 16;
+        std::ostream null_out{&discard};
+        names.clear();
+        names.shrink_to_fit();
+        double t_producer = 0;
+        auto t_async = time_ms([&] {
+            async_logger logger{null_out, overflow_policy::block, burst};
+            t_producer = time_ms([&] {
+                for (std::size_t i = 0; i < burst; ++i) {
+                    log_and_add_4(logger, incoming[i]);
+                }
+            });
+            logger.flush();
+        });
+        std::println("por registro | síncrono: {:.1f} ns | assíncrono: {:.1f} "
+                     "ns na 'thread' chamadora, {:.1f} ns no total",
+                     t_single * 1e6 / n, t_producer * 1e6 / burst,
+                     t_async * 1e6 / burst);
+    };
+    {
+        // Comparação entre armazenar 1'000'000 de nomes repetidos de
+        // 'name_from_idx' como 'std::string' ou como símbolos de
+        // 'intern_table':
+        cout << endl;
+        constexpr int n = 1'000'000;
+        auto table = name_from_idx.load();
+
+        vector<string> as_strings;
+        vector<intern_table::symbol> as_symbols;
+        intern_table symbols;
+        auto t_strings = time_ms([&] {
+            for (int i = 0; i < n; ++i) {
+                as_strings.emplace_back((*table)[i % table->size()]);
+            }
+        });
+        auto t_symbols = time_ms([&] {
+            for (int i = 0; i < n; ++i) {
+                as_symbols.emplace_back(
+                    symbols.intern((*table)[i % table->size()]));
+            }
+        });
+        // Nomes com até 15 caracteres cabem no 'buffer' interno de
+        // 'std::string' ('small string optimization'); nomes maiores ainda
+        // teriam uma alocação própria cada.
+        auto bytes_strings = as_strings.capacity() * sizeof(string);
+        auto bytes_symbols =
+            as_symbols.capacity() * sizeof(intern_table::symbol) +
+            symbols.arena_bytes();
+        std::println("std::string: {:.2f} ms | {} bytes", t_strings,
+                     bytes_strings);
+        std::println("símbolos:    {:.2f} ms | {} bytes", t_symbols,
+                     bytes_symbols);
+
+        // Igualdade: comparação de 'strings' contra comparação de inteiros.
+        std::size_t eq_strings = 0;
+        std::size_t eq_symbols = 0;
+        auto dante = symbols.intern("Dante");
+        auto t_eq_strings = time_ms([&] {
+            for (const auto& s : as_strings) eq_strings += (s == "Dante");
+        });
+        auto t_eq_symbols = time_ms([&] {
+            for (auto s : as_symbols) eq_symbols += (s == dante);
+        });
+        std::println("igualdade | std::string: {:.2f} ms ({}) | símbolos: "
+                     "{:.2f} ms ({})",
+                     t_eq_strings, eq_strings, t_eq_symbols, eq_symbols);
+    };
 };
 }  // namespace item_26
@@ -1,16 +1,23 @@
+#include <algorithm>
 #include <boost/type_index.hpp>
 #include <chrono>
+#include <concepts>
 #include <functional>
 #include <iostream>
 #include <list>
 #include <memory>
 #include <print>
 #include <ranges>
+#include <string_view>
 #include <type_traits>
 #include <unordered_map>
 #include <variant>
 #include <vector>
 
+#include "intern_table.hpp"
+#include "snapshot.hpp"
+#include "timestamp.hpp"
+
 namespace item_27 {
 using boost::typeindex::type_id_with_cvr;
 using std::cout;
@@ -45,27 +52,75 @@ auto stringify(Rng&& seq) {
     return "{" + std::string(std::begin(b), std::end(b)) + "}";
 };
 
-vector<string> names{};
+// Os nomes registrados são armazenados como símbolos de uma tabela de
+// 'interning' (./intern_table.hpp): cada nome distinto é guardado uma única
+// vez e 'names' contém apenas identificadores de 32 bits. As discussões sobre
+// cópias e movimentações para dentro de 'names' referem-se à versão original,
+// com 'std::string', na qual o argumento era de fato copiado ou movido:
+// vector<string> names{};
+intern_table name_symbols;
+vector<intern_table::symbol> names{};
 
 // Implementação de 'Tag Dispatch':
 //
-vector<string> name_from_idx{
+// Tabela 'read-mostly' publicada como 'snapshot' imutável (ver
+// './snapshot.hpp').
+snapshot<vector<string>> name_from_idx{
     "Dante",
     "Vergil",
     "Nero",
 };
 void log_and_add_impl(int idx, std::true_type) {
-    auto now = std::chrono::system_clock::now();
-    cout << std::format("name: {} | time: {}", name_from_idx[idx], now) << endl;
-    names.emplace_back(name_from_idx[idx]);
+    auto now = tsc_clock::to_sys(tsc_clock::now());
+    auto table = name_from_idx.load();
+    cout << std::format("name: {} | time: {}", (*table)[idx], now) << endl;
+    names.emplace_back(name_symbols.intern((*table)[idx]));
 }
 
 template <typename T>
 void log_and_add_impl(T&& name, std::false_type) {
     // cout << type_id_with_cvr<decltype(name)>().pretty_name() << endl;
-    auto now = std::chrono::system_clock::now();
+    auto now = tsc_clock::to_sys(tsc_clock::now());
     cout << std::format("name: {} | time: {}", name, now) << endl;
-    names.emplace_back(std::forward<T>(name));
+    names.emplace_back(name_symbols.intern(std::forward<T>(name)));
+}
+
+// Versão em lote: qualquer 'range' de nomes ou de índices de 'name_from_idx'.
+// Reserva espaço em 'names' uma única vez e registra uma única linha (e um
+// único 'timestamp') por lote. 'strings', que também são 'ranges' de
+// caracteres, são excluídas.
+template <typename R>
+concept NameBatch =
+    rg::input_range<R> && !std::convertible_to<R, std::string_view> &&
+    (std::convertible_to<rg::range_reference_t<R>, std::string_view> ||
+     std::integral<rg::range_value_t<R>>);
+
+struct batch_tag {};
+
+template <NameBatch R>
+void log_and_add_impl(R&& batch, batch_tag) {
+    auto now = tsc_clock::to_sys(tsc_clock::now());
+    if constexpr (rg::sized_range<R>) {
+        // Mantém o crescimento geométrico mesmo com vários lotes pequenos.
+        auto needed = names.size() + rg::size(batch);
+        if (needed > names.capacity()) {
+            names.reserve(std::max(needed, 2 * names.capacity()));
+        }
+    }
+    auto before = names.size();
+    if constexpr (std::integral<rg::range_value_t<R>>) {
+        auto table = name_from_idx.load();
+        for (auto idx : batch) {
+            names.emplace_back(name_symbols.intern((*table)[idx]));
+        }
+    } else {
+        for (auto&& name : batch) {
+            names.emplace_back(name_symbols.intern(name));
+        }
+    }
+    cout << std::format("batch: {} names | time: {}", names.size() - before,
+                        now)
+         << endl;
 }
 
 // Uma função com a interface geral para o usuário é definida de tal forma que
@@ -75,10 +130,13 @@ void log_and_add_impl(T&& name, std::false_type) {
 // função desejada.
 template <typename T>
 void log_and_add(T&& name) {
-    // o segundo argumento é uma 'tag' que retornará 'true' caso o argumento for
-    // do tipo 'integral' e 'false' caso contrário:
-    log_and_add_impl(std::forward<T>(name),
-                     std::is_integral<std::remove_reference_t<T>>());
+    // o segundo argumento é uma 'tag' que retornará 'batch_tag' caso o
+    // argumento seja um lote de nomes, 'true' caso for do tipo 'integral' e
+    // 'false' caso contrário:
+    using tag =
+        std::conditional_t<NameBatch<T>, batch_tag,
+                           std::is_integral<std::remove_reference_t<T>>>;
+    log_and_add_impl(std::forward<T>(name), tag{});
 }
 
 template <typename T, typename S>
@@ -119,7 +177,7 @@ class Foo {  // (1)
     };
 
     // Construtor especializado para argumentos de tipo 'integral':
-    Foo(int idx) : name{name_from_idx[idx]} {
+    Foo(int idx) : name{(*name_from_idx.load())[idx]} {
         cout << "'int' specialized constructor" << endl;
     };
 
@@ -187,6 +245,8 @@ void main() {
         log_and_add("Paty");    // utilizará 'log_and_add_impl(T&& name) {...};'
         log_and_add(2);         // utilizará 'log_and_add_impl(int idx) {...};'
         log_and_add(short{0});  // utilizará 'log_and_add_impl(int idx) {...};'
+        log_and_add(vector<string>{"Lady", "Trish"});  // 'batch_tag'.
+        log_and_add(vector<int>{0, 1, 2});              // 'batch_tag'.
     };
     // Por fim, pode-se fazer uso de 'template metaprogramming' para uma
     // melhor condução do fluxo de execução (1):
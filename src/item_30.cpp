@@ -1,11 +1,22 @@
 #include <boost/type_index.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <memory>
 #include <optional>
+#include <print>
+#include <random>
 #include <ranges>
 #include <type_traits>
 #include <vector>
 
+#include "bench.hpp"
+#include "function_ref.hpp"
+#include "ipv4_columns.hpp"
+#include "pcap_reader.hpp"
+
 namespace item_30 {
 using boost::typeindex::type_id_with_cvr;
 using std::cout;
@@ -52,6 +63,16 @@ decltype(auto) fwd(Func func, Args... args) {
     return func(std::forward<Args>(args)...);
 }
 
+// Versões não 'template' de 'fwd', com assinaturas fixas, por meio de
+// 'function_ref' (./function_ref.hpp). Como não há dedução de tipo dos
+// argumentos, os casos de falha do 'perfect forwarding' abordados em 'main'
+// com '{...}' e com 'NULL' e '0' deixam de existir:
+string fwd_ref(function_ref<string(const vector<int>&)> func,
+               const vector<int>& v) {
+    return func(v);
+}
+string fwd_ref(function_ref<string(int*)> func, int* p) { return func(p); }
+
 // Duas funções, de mesmo nome, para simular situação de sobrecarga em
 // argumento:
 int process_val(int val) { return val; }
@@ -90,6 +111,19 @@ struct IPv4Header {
     std::uint32_t total_length : 16;
 };
 
+// Decodificação de um cabeçalho em ordem de rede para 'IPv4Header', um campo
+// por vez (ver './ipv4_columns.hpp' para a versão em lote):
+IPv4Header decode_header(const std::byte* raw) {
+    const auto* h = reinterpret_cast<const std::uint8_t*>(raw);
+    IPv4Header header;
+    header.version = h[0] >> 4;
+    header.IHL = h[0] & 0x0F;
+    header.DSCP = h[1] >> 2;
+    header.ECN = h[1] & 0x03;
+    header.total_length = h[2] << 8 | h[3];
+    return header;
+}
+
 void main() {
     // 'std::forward<T>', introduzido pela standard C++11, permite repassar seus
     // argumentos para outras estruturas de forma condicional, preservando a
@@ -144,6 +178,7 @@ void main() {
         cout << "auto il = {1, 2, 3};" << endl;
         auto il = {1, 2, 3};
         cout << "fwd(f, il): " << fwd(f, il) << endl;
+        cout << "fwd_ref(f, {1, 2, 3}): " << fwd_ref(f, {1, 2, 3}) << endl;
     };
     {
         // O próximo caso é quando ou uso de ponteiros e em especial, o uso de
@@ -174,6 +209,7 @@ void main() {
         // fwd(f, NULL);  // Erro: O tipo deduzido pela função é 'long int'
         // fwd(f, 0);     // Erro: O tipo deduzido pela função é 'int'
         cout << "fwd(f, nullptr): " << fwd(f, nullptr) << endl;
+        cout << "fwd_ref(f, 0): " << fwd_ref(f, 0) << endl;
         // Entretanto a função 'fwd' falha quando os ponteiros nulos são 'NULL'
         // e '0'. A única alternativa então é fazer uso de 'nullptr' para
         // indicar a nulidade de determinado ponteiro.
@@ -277,5 +313,122 @@ void main() {
         fwd(f, l);
         fwd(f, static_cast<std::uint32_t>(h.total_length));
     };
+    {
+        // Decodificação de 1'000'000 de cabeçalhos (20 bytes cada): um
+        // 'IPv4Header' por vez, contra a decodificação em lote para colunas
+        // (escalar e SIMD).
+        cout << endl;
+        constexpr std::size_t n = 1'000'000;
+        std::vector<std::byte> raw(n * ipv4_min_header_size);
+        std::mt19937 rng{42};
+        for (std::size_t i = 0; i < n; ++i) {
+            auto* h = raw.data() + i * ipv4_min_header_size;
+            auto length = static_cast<std::uint16_t>(20 + rng() % 1480);
+            h[0] = std::byte{0x45};  // versão 4, IHL 5.
+            h[1] = static_cast<std::byte>(rng());
+            h[2] = static_cast<std::byte>(length >> 8);
+            h[3] = static_cast<std::byte>(length & 0xFF);
+        }
+        auto gb_per_s = [&](double ms) { return raw.size() / (ms * 1e6); };
+
+        std::vector<IPv4Header> headers(n);
+        auto t_struct = time_ms([&] {
+            for (std::size_t i = 0; i < n; ++i) {
+                headers[i] =
+                    decode_header(raw.data() + i * ipv4_min_header_size);
+            }
+        });
+        do_not_optimize(headers);
+
+        IPv4Columns columns;
+        columns.resize(n);
+        ipv4_kernels::Out out{columns.version.data(), columns.IHL.data(),
+                              columns.DSCP.data(), columns.ECN.data(),
+                              columns.total_length.data()};
+        auto t_scalar = time_ms([&] {
+            ipv4_kernels::scalar(raw.data(), n, ipv4_min_header_size, out);
+        });
+        do_not_optimize(columns);
+        auto t_batch = time_ms([&] { decode_ipv4_headers(raw, columns); });
+        do_not_optimize(columns);
+
+        std::println("IPv4Header: {:.2f} ms ({:.2f} GB/s)", t_struct,
+                     gb_per_s(t_struct));
+        std::println("colunas (escalar): {:.2f} ms ({:.2f} GB/s)", t_scalar,
+                     gb_per_s(t_scalar));
+        std::println("colunas (lote): {:.2f} ms ({:.2f} GB/s)", t_batch,
+                     gb_per_s(t_batch));
+
+        std::size_t total = 0;
+        for (auto len : columns.total_length) total += len;
+        std::println("headers[0].total_length: {} | columns.total_length[0]: "
+                     "{} | soma: {}",
+                     static_cast<unsigned>(headers[0].total_length),
+                     columns.total_length[0], total);
+    };
+    {
+        // Leitura de uma captura 'pcap' (Ethernet + IPv4) com 'std::ifstream',
+        // copiando cada pacote para um 'buffer', contra 'pcap_reader', que
+        // percorre o arquivo mapeado em memória sem cópias.
+        cout << endl;
+        auto path = std::filesystem::temp_directory_path() / "item_30.pcap";
+        constexpr std::uint32_t packets = 200'000;
+        {
+            std::ofstream out{path, std::ios::binary};
+            auto put = [&](auto v) {
+                out.write(reinterpret_cast<const char*>(&v), sizeof(v));
+            };
+            put(std::uint32_t{0xA1B2C3D4});  // 'magic' (microssegundos).
+            put(std::uint16_t{2});           // versão 2.4.
+            put(std::uint16_t{4});
+            put(std::uint32_t{0});
+            put(std::uint32_t{0});
+            put(std::uint32_t{65535});  // 'snaplen'.
+            put(std::uint32_t{1});      // LINKTYPE_ETHERNET.
+            std::mt19937 rng{42};
+            for (std::uint32_t i = 0; i < packets; ++i) {
+                auto length = static_cast<std::uint16_t>(40 + rng() % 60);
+                std::vector<char> frame(14 + length);
+                frame[12] = 0x08;  // 'ethertype' IPv4.
+                frame[14] = 0x45;
+                frame[15] = static_cast<char>(rng());
+                frame[16] = static_cast<char>(length >> 8);
+                frame[17] = static_cast<char>(length & 0xFF);
+                put(i / 1000);  // segundos.
+                put(i % 1000);  // microssegundos.
+                put(static_cast<std::uint32_t>(frame.size()));
+                put(static_cast<std::uint32_t>(frame.size()));
+                out.write(frame.data(), std::ssize(frame));
+            }
+        }
+
+        std::uint64_t sum_stream = 0;
+        auto t_stream = time_ms([&] {
+            std::ifstream in{path, std::ios::binary};
+            in.ignore(24);
+            std::uint32_t rec[4];
+            std::vector<char> frame;
+            while (in.read(reinterpret_cast<char*>(rec), sizeof(rec))) {
+                frame.resize(rec[2]);
+                in.read(frame.data(), rec[2]);
+                IPv4Header h = decode_header(
+                    reinterpret_cast<const std::byte*>(frame.data() + 14));
+                sum_stream += h.total_length;
+            }
+        });
+
+        std::uint64_t sum_mmap = 0;
+        auto t_mmap = time_ms([&] {
+            pcap_reader reader{path};
+            for (IPv4HeaderView h : reader.ipv4_headers()) {
+                sum_mmap += h.total_length();
+            }
+        });
+        std::filesystem::remove(path);
+
+        std::println("std::ifstream: {:.2f} ms (soma: {})", t_stream,
+                     sum_stream);
+        std::println("pcap_reader:   {:.2f} ms (soma: {})", t_mmap, sum_mmap);
+    };
 };
 }  // namespace item_30
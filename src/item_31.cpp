@@ -2,10 +2,15 @@
 #include <functional>
 #include <iostream>
 #include <memory>
+#include <print>
 #include <ranges>
 #include <type_traits>
 #include <vector>
 
+#include "bench.hpp"
+#include "closure_store.hpp"
+#include "inplace_function.hpp"
+
 namespace item_31 {
 using boost::typeindex::type_id_with_cvr;
 using std::cout;
@@ -235,5 +240,130 @@ void main() {
         // Em termos práticos é como se a função 'lambda' tivesse pego a
         // variável do tipo 'static' por referência.
     };
+    {
+        // 'std::function' aloca memória na 'heap' para funções 'lambda' cujas
+        // capturas não caibam no seu 'buffer' interno (16 bytes na libstdc++).
+        // 'inplace_function' (./inplace_function.hpp) sempre armazena a função
+        // no próprio objeto, e aceita também funções que só podem ser movidas:
+        cout << endl;
+        vector<inplace_function<int()>> functions;
+        {
+            auto w = mu<Widget>();
+            w->add_function_2(functions);
+        }
+        auto p = mu<int>(7);
+        functions.push_back([p = std::move(p)]() { return *p; });
+        cout << "functions[0](): " << functions[0]() << endl;
+        cout << "functions[1](): " << functions[1]() << endl;
+    };
+    {
+        // Inserção e invocação de 1'000'000 de funções 'lambda' com 24 bytes
+        // de capturas.
+        cout << endl;
+        constexpr int n = 1'000'000;
+        auto run = [&]<typename Function>(std::type_identity<Function>) {
+            vector<Function> functions;
+            functions.reserve(n);
+            auto t_push = time_ms([&] {
+                for (int i = 0; i < n; ++i) {
+                    functions.push_back(
+                        [a = i, b = 2.0 * i, c = 0.5]() { return a + b * c; });
+                }
+            });
+            double total = 0;
+            auto t_call = time_ms([&] {
+                for (auto& f : functions) total += f();
+            });
+            do_not_optimize(total);
+            return std::pair{t_push, t_call};
+        };
+        auto [function_push, function_call] =
+            run(std::type_identity<std::function<double()>>{});
+        auto [move_only_push, move_only_call] =
+            run(std::type_identity<std::move_only_function<double()>>{});
+        auto [inplace_push, inplace_call] =
+            run(std::type_identity<inplace_function<double()>>{});
+        std::println("std::function:           inserção {:.2f} ms | "
+                     "invocação {:.2f} ms",
+                     function_push, function_call);
+        std::println("std::move_only_function: inserção {:.2f} ms | "
+                     "invocação {:.2f} ms",
+                     move_only_push, move_only_call);
+        std::println("inplace_function:        inserção {:.2f} ms | "
+                     "invocação {:.2f} ms",
+                     inplace_push, inplace_call);
+    };
+    {
+        // 'closure_store' (./closure_store.hpp) agrupa as funções pelo seu
+        // tipo concreto, e devolve um 'handle' para a remoção:
+        cout << endl;
+        closure_store<int()> functions;
+        {
+            auto w = mu<Widget>();
+            w->add_function_2(functions);
+        }
+        auto h = functions.push_back([]() { return 42; });
+        functions.push_back([]() { return 7; });
+        vector<int> results;
+        functions.invoke_all(results);
+        cout << "functions.invoke_all(results): " << stringify(results)
+             << endl;
+        functions.erase(h);
+        results.clear();
+        functions.invoke_all(results);
+        cout << "functions.erase(h); functions.invoke_all(results): "
+             << stringify(results) << endl;
+    };
+    {
+        // 100 invocações de 100'000 'callbacks' de 4 tipos distintos,
+        // inseridos de forma intercalada (como num 'loop' de eventos):
+        cout << endl;
+        constexpr int n = 100'000;
+        constexpr int rounds = 100;
+        auto fill = [](auto& functions) {
+            for (int i = 0; i < n; ++i) {
+                switch (i % 4) {
+                    case 0:
+                        functions.push_back([i](long& acc) { acc += i; });
+                        break;
+                    case 1:
+                        functions.push_back([i](long& acc) { acc ^= i; });
+                        break;
+                    case 2:
+                        functions.push_back(
+                            [a = i, b = 3L](long& acc) { acc += a * b; });
+                        break;
+                    default:
+                        functions.push_back(
+                            [a = i, b = 1L, c = 2L, d = 3L](long& acc) {
+                                acc -= a + b * c - d;
+                            });
+                }
+            }
+        };
+        auto run = [&](auto& functions, auto invoke_all) {
+            fill(functions);
+            long acc = 0;
+            auto t = time_ms([&] {
+                for (int r = 0; r < rounds; ++r) invoke_all(functions, acc);
+            });
+            do_not_optimize(acc);
+            return t;
+        };
+        auto each = [](auto& functions, long& acc) {
+            for (auto& f : functions) f(acc);
+        };
+        vector<std::function<void(long&)>> function_vec;
+        vector<inplace_function<void(long&)>> inplace_vec;
+        closure_store<void(long&)> store;
+        auto t_function = run(function_vec, each);
+        auto t_inplace = run(inplace_vec, each);
+        auto t_store = run(store, [](auto& functions, long& acc) {
+            functions.invoke_all(acc);
+        });
+        std::println("vector<std::function>:    {:.2f} ms", t_function);
+        std::println("vector<inplace_function>: {:.2f} ms", t_inplace);
+        std::println("closure_store:            {:.2f} ms", t_store);
+    };
 };
 }  // namespace item_31
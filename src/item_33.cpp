@@ -5,6 +5,8 @@
 #include <type_traits>
 #include <vector>
 
+#include "function_ref.hpp"
+
 namespace item_33 {
 using boost::typeindex::type_id_with_cvr;
 using std::cout;
@@ -88,5 +90,19 @@ void main() {
 
         f([](auto a) { cout << to_string(a) << endl; }, "aldkfj"s);
     };
+    {
+        cout << endl;
+
+        // Cada tipo de função passado para as 'lambdas' genéricas acima gera
+        // uma nova instanciação. Quando a assinatura é conhecida, a 'lambda'
+        // invocadora pode receber um 'function_ref' (./function_ref.hpp), que
+        // referencia qualquer invocável compatível sem alocar memória:
+        auto f = [](function_ref<void(string)> func, string a) {
+            func(std::move(a));
+        };
+
+        f([](auto a) { cout << to_string(a) << endl; }, "aldkfj"s);
+        f([](const string& a) { cout << a.size() << endl; }, "aldkfj"s);
+    };
 };
 }  // namespace item_33
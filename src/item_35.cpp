@@ -10,6 +10,8 @@
 #include <type_traits>
 #include <vector>
 
+#include "thread_pool.hpp"
+
 namespace item_35 {
 using boost::typeindex::type_id_with_cvr;
 using std::cout;
@@ -215,5 +217,42 @@ void main() {
     // API disponível pela linguagem C++, como no caso de 'threadpool's em
     // plataformas que não as fornecem.
     //
+    // Uma 'threadpool' com roubo de tarefas ('work stealing') encontra-se em
+    // ./thread_pool.hpp. As 'threads' são criadas uma única vez, e cada
+    // tarefa submetida custa apenas uma alocação e uma inserção numa fila.
+    // Tarefas que bloqueiam (como 'do_async_work', com 'sleep_for') ocupam um
+    // 'worker' durante todo o bloqueio: o 'pool' é mais indicado para tarefas
+    // 'cpu-bound'.
+    {
+        cout << endl;
+
+        cout << "size_t cnt{0};" << endl;
+        std::size_t cnt{0};
+        cout << "std::mutex m{};" << endl;
+        std::mutex m{};
+        cout << "thread_pool pool{4};" << endl;
+        thread_pool pool{4};
+
+        cout << "vector<std::future<int>> futures;\n"
+                "for (int _ : vw::iota(0, 4)) {\n"
+                "    futures.push_back(pool.submit(\n"
+                "        static_cast<int (*)(std::size_t&, "
+                "std::mutex&)>(do_async_work),\n"
+                "        std::ref(cnt), std::ref(m)));\n"
+                "}"
+             << endl;
+        vector<std::future<int>> futures;
+        for (int _ : vw::iota(0, 4)) {
+            futures.push_back(pool.submit(
+                static_cast<int (*)(std::size_t&, std::mutex&)>(do_async_work),
+                std::ref(cnt), std::ref(m)));
+        }
+
+        int res = std::accumulate(
+            std::begin(futures), std::end(futures), 0,
+            [](int i, std::future<int>& b) { return i + b.get(); });
+
+        cout << "res: " << res << "  " << "cnt: " << cnt << endl;
+    };
 };
 }  // namespace item_35
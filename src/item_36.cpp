@@ -1,11 +1,16 @@
 #include <boost/type_index.hpp>
 #include <future>
 #include <iostream>
+#include <latch>
 #include <memory>
+#include <print>
 #include <ranges>
 #include <type_traits>
 #include <vector>
 
+#include "bench.hpp"
+#include "thread_pool.hpp"
+
 namespace item_36 {
 using boost::typeindex::type_id_with_cvr;
 using std::cout;
@@ -96,5 +101,53 @@ void main() {
         auto future = reall_async([](int i) { return i * 2; }, 3);
         cout << "future.get(): " << future.get() << endl;
     };
+    // 'reall_async' garante a execução assíncrona ao custo de uma nova
+    // 'thread' por tarefa. 'pool_async' (./thread_pool.hpp) possui a mesma
+    // assinatura, mas executa as tarefas num conjunto fixo de 'threads'
+    // ('default_thread_pool()'), que são reaproveitadas. Por consequência,
+    // variáveis 'thread_local' persistem de uma tarefa para outra, e a
+    // destruição do 'std::future' não aguarda o término da tarefa.
+    {
+        cout << endl;
+        cout << "auto future = pool_async([](int i) { return i * 2; }, 3);"
+             << endl;
+        auto future = pool_async([](int i) { return i * 2; }, 3);
+        cout << "future.get(): " << future.get() << endl;
+    };
+    {
+        // Comparação do custo de submissão de tarefas pequenas.
+        cout << endl;
+        constexpr int n = 10'000;
+        auto work = [](int i) { return i * 2; };
+        auto submit_all = [&](auto launch) {
+            return time_ms([&] {
+                vector<std::future<int>> futures;
+                futures.reserve(n);
+                for (int i = 0; i < n; ++i) futures.push_back(launch(work, i));
+                long total = 0;
+                for (auto& f : futures) total += f.get();
+                do_not_optimize(total);
+            });
+        };
+        auto t_async =
+            submit_all([](auto&& f, int i) { return reall_async(f, i); });
+        auto t_pool =
+            submit_all([](auto&& f, int i) { return pool_async(f, i); });
+        std::println("{} tarefas | reall_async: {:.2f} ms | pool_async: {:.2f} "
+                     "ms",
+                     n, t_async, t_pool);
+
+        // Sem o 'std::future', o custo por tarefa é o de uma alocação e de
+        // uma inserção numa fila.
+        constexpr int m = 1'000'000;
+        auto t_post = time_ms([&] {
+            std::latch done{m};
+            for (int i = 0; i < m; ++i) {
+                default_thread_pool().post([&done] { done.count_down(); });
+            }
+            done.wait();
+        });
+        std::println("{} tarefas | thread_pool::post: {:.2f} ms", m, t_post);
+    };
 };
 }  // namespace item_36
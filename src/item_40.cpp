@@ -1,5 +1,6 @@
 #include <atomic>
 #include <boost/type_index.hpp>
+#include <future>
 #include <iostream>
 #include <memory>
 #include <ranges>
@@ -7,6 +8,8 @@
 #include <type_traits>
 #include <vector>
 
+#include "thread_pool.hpp"
+
 namespace item_40 {
 using boost::typeindex::type_id_with_cvr;
 using std::cout;
@@ -94,13 +97,18 @@ void main() {
         };
 
         cout << "{\n"
-                "    std::vector<std::jthread> pool;\n"
-                "    for (int n = 0; n < 10; ++n) pool.emplace_back(f);\n"
+                "    std::vector<std::future<void>> futures;\n"
+                "    for (int n = 0; n < 10; ++n) "
+                "futures.push_back(pool_async(f));\n"
+                "    for (auto& fut : futures) fut.get();\n"
                 "}"
              << endl;
         {
-            std::vector<std::jthread> pool;
-            for (int n = 0; n < 10; ++n) pool.emplace_back(f);
+            // As tarefas são executadas pelas 'threads' de
+            // './thread_pool.hpp', ao invés de uma nova 'thread' por tarefa.
+            std::vector<std::future<void>> futures;
+            for (int n = 0; n < 10; ++n) futures.push_back(pool_async(f));
+            for (auto& fut : futures) fut.get();
         }
         cout << "a_count: " << a_count
              << endl;  // nesta linha, estão pelo menos duas operações com o
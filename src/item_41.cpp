@@ -1,10 +1,14 @@
 #include <boost/type_index.hpp>
+#include <cassert>
 #include <iostream>
 #include <memory>
 #include <ranges>
 #include <type_traits>
 #include <vector>
 
+#include "counting_probe.hpp"
+#include "small_vector.hpp"
+
 namespace item_41 {
 using boost::typeindex::type_id_with_cvr;
 using std::cout;
@@ -106,6 +110,23 @@ class MoveOnlyFoo {
     int copy_count{0};
 };
 
+// Tipo 'move-only' cujo construtor de movimentação não é 'noexcept'. Sem
+// construtor de cópia, 'std::move_if_noexcept' recorre à movimentação, e o
+// crescimento de um container oferece apenas a garantia básica de exceção.
+class ThrowingMoveOnlyFoo {
+   public:
+    explicit ThrowingMoveOnlyFoo(int x) : x{x} {}
+    ThrowingMoveOnlyFoo(ThrowingMoveOnlyFoo&& foo) : x{foo.x} {}
+    ThrowingMoveOnlyFoo(const ThrowingMoveOnlyFoo&) = delete;
+    ThrowingMoveOnlyFoo& operator=(ThrowingMoveOnlyFoo&& foo) {
+        x = foo.x;
+        return *this;
+    }
+    ThrowingMoveOnlyFoo& operator=(const ThrowingMoveOnlyFoo&) = delete;
+
+    int x{0};
+};
+
 class Widget {
    public:
     // Duas funções que operam sob sobrecarga:
@@ -142,8 +163,34 @@ class Widget {
     // 'push_back'). Entretanto parece que o compilador está realizando
     // operações de otimização e inibindo determinadas instanciações.
 
-    vector<Foo> foos;
-    vector<MoveOnlyFoo> move_only_foos;
+    // Como os vetores internos costumam ter poucos elementos, os primeiros
+    // são armazenados no próprio objeto (./small_vector.hpp), evitando
+    // alocações na 'heap':
+    small_vector<Foo, 4> foos;
+    small_vector<MoveOnlyFoo, 4> move_only_foos;
+};
+
+// Alocador que apenas contabiliza o número de alocações realizadas, para a
+// comparação entre 'std::vector' e 'small_vector' abaixo.
+long allocation_count = 0;
+
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+    CountingAllocator() = default;
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>&) {}
+    T* allocate(std::size_t n) {
+        ++allocation_count;
+        return std::allocator<T>{}.allocate(n);
+    }
+    void deallocate(T* p, std::size_t n) {
+        std::allocator<T>{}.deallocate(p, n);
+    }
+    template <typename U>
+    bool operator==(const CountingAllocator<U>&) const {
+        return true;
+    }
 };
 
 void main() {
@@ -221,6 +268,17 @@ void main() {
         // Provavelmente o compilador está realizando operações de otimização
         // ("move elision").
     };
+    {
+        // Assim como 'std::vector', 'small_vector' aceita tipos 'move-only'
+        // cujo construtor de movimentação pode emitir exceções: ao crescer,
+        // os elementos são movidos, já que não há como copiá-los.
+        cout << endl;
+        small_vector<ThrowingMoveOnlyFoo, 2> throwing_foos;
+        for (int i = 0; i < 5; ++i) throwing_foos.emplace_back(i);
+        cout << "throwing_foos.size(): " << throwing_foos.size() << "  "
+             << "throwing_foos[4].x: " << throwing_foos[4].x << endl;
+        // throwing_foos.size(): 5  throwing_foos[4].x: 4
+    };
 
     // Percebe-se pelos resultados dos 3 grupos de funções que é interessante
     // passar argumentos por valor quando já se espera a ocorrência de operações
@@ -255,5 +313,74 @@ void main() {
     // Por fim, a informação de argumentos para funções 'by-value' ainda pode
     // acarretar em problemas sérios como 'slicing' de tipos definidos pelo
     // usuário.
+    {
+        // Os contadores de 'Foo' e 'MoveOnlyFoo' são por instância e precisam
+        // ser reescritos em cada classe. 'CountingProbe<T>'
+        // (./counting_probe.hpp) envolve qualquer tipo 'T' e contabiliza as
+        // operações num registro global por tipo. 'ProbeScope<T>' permite
+        // obter apenas as operações realizadas dentro de um trecho de código:
+        cout << endl;
+        using ProbeFoo = CountingProbe<int>;
+        using ProbeMoveOnlyFoo = CountingProbe<up<int>>;
+
+        vector<ProbeFoo> foos;
+        foos.reserve(8);
+        ProbeFoo foo{42};
+        {
+            ProbeScope<int> scope;
+            foos.push_back(foo);
+            cout << "foos.push_back(foo): " << scope.delta() << endl;
+        }
+        {
+            ProbeScope<int> scope;
+            foos.push_back(ProbeFoo{42});
+            cout << "foos.push_back(ProbeFoo{42}): " << scope.delta() << endl;
+        }
+        {
+            ProbeScope<int> scope;
+            foos.emplace_back(42);
+            cout << "foos.emplace_back(42): " << scope.delta() << endl;
+        }
+
+        // Verificação de que um caminho não realiza nenhuma cópia:
+        vector<ProbeMoveOnlyFoo> move_only_foos;
+        {
+            ProbeScope<up<int>> scope;
+            for (int i = 0; i < 100; ++i) {
+                move_only_foos.emplace_back(mu<int>(i));
+            }
+            assert(scope.delta().copies() == 0);
+            cout << "100 x move_only_foos.emplace_back(mu<int>(i)): "
+                 << scope.delta() << endl;
+        }
+
+        cout << "ProbeRegistry::report(cout):" << endl;
+        ProbeRegistry::report(cout);
+    };
+    {
+        // Alocações realizadas pelas operações 'add_foo_*' de 10000 'Widgets'
+        // com até 4 'Foos' cada, armazenados em 'std::vector' e em
+        // 'small_vector<Foo, 4>':
+        cout << endl;
+        auto workload = [](auto make_container) {
+            allocation_count = 0;
+            for (int i = 0; i < 10'000; ++i) {
+                auto foos = make_container();
+                Foo foo{};
+                foos.push_back(foo);             // add_foo_1(foo)
+                foos.push_back(Foo{});           // add_foo_2(Foo{})
+                foos.push_back(std::move(foo));  // add_foo_3(std::move(foo))
+                foos.emplace_back();
+            }
+            return allocation_count;
+        };
+        auto n_vector =
+            workload([] { return vector<Foo, CountingAllocator<Foo>>{}; });
+        auto n_small = workload(
+            [] { return small_vector<Foo, 4, CountingAllocator<Foo>>{}; });
+        cout << "std::vector<Foo>:     " << n_vector << " alocações" << endl;
+        cout << "small_vector<Foo, 4>: " << n_small << " alocações" << endl;
+        cout << "alocações evitadas:   " << n_vector - n_small << endl;
+    };
 };
 }  // namespace item_41
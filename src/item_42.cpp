@@ -2,10 +2,14 @@
 #include <iostream>
 #include <list>
 #include <memory>
+#include <print>
 #include <ranges>
 #include <type_traits>
 #include <vector>
 
+#include "bench.hpp"
+#include "hive.hpp"
+
 namespace item_42 {
 using boost::typeindex::type_id_with_cvr;
 using std::cout;
@@ -292,5 +296,74 @@ void main() {
         // construtores do tipo 'explict' poderão ser utilizados pelo
         // compilador.
     };
+    {
+        // Quando a ordem dos elementos não importa, 'std::list' (um nó alocado
+        // por elemento, além do 'control block' e do próprio 'Widget') pode
+        // ser substituída por 'hive' (./hive.hpp): os elementos ficam em
+        // blocos contíguos, com endereços estáveis e inserção/remoção em O(1).
+        cout << endl;
+        auto kill_Widget = [](Widget* pw) { delete pw; };
+        hive<std::shared_ptr<Widget>> shared_widgets;
+        auto spw = std::shared_ptr<Widget>(new Widget, kill_Widget);
+        shared_widgets.insert(std::move(spw));
+
+        // Caso a posse seja única, o 'std::shared_ptr' é dispensável: o
+        // próprio 'Widget' é construído dentro do container, e o seu endereço
+        // permanece válido até a sua remoção.
+        hive<Widget> widgets;
+        Widget* pw = &*widgets.emplace();
+        for (int i = 0; i < 99; ++i) widgets.emplace();
+        cout << "widgets.size(): " << widgets.size() << endl;
+        widgets.erase(widgets.get_iterator(pw));
+        cout << "widgets.size(): " << widgets.size() << endl;
+    };
+    {
+        // Comparação do padrão de 'ptrs': inserção de 'n' elementos, remoção
+        // de um a cada três, reinserção do mesmo número de elementos e 10
+        // iterações completas.
+        cout << endl;
+        struct Particle {
+            double position{0};
+            double velocity{1};
+        };
+        constexpr int n = 200'000;
+
+        auto workload = [&](auto& container, auto add, auto get) {
+            return time_ms([&] {
+                for (int i = 0; i < n; ++i) add(container);
+                int k = 0;
+                for (auto it = container.begin(); it != container.end();) {
+                    it = (k++ % 3 == 0) ? container.erase(it) : std::next(it);
+                }
+                for (int i = 0; i < n / 3; ++i) add(container);
+                double total = 0;
+                for (int pass = 0; pass < 10; ++pass) {
+                    for (auto& e : container) {
+                        Particle& p = get(e);
+                        p.position += p.velocity;
+                        total += p.position;
+                    }
+                }
+                do_not_optimize(total);
+            });
+        };
+        auto deref = [](auto& sp) -> Particle& { return *sp; };
+
+        std::list<std::shared_ptr<Particle>> list_of_shared;
+        hive<std::shared_ptr<Particle>> hive_of_shared;
+        hive<Particle> hive_of_values;
+        auto t_list = workload(
+            list_of_shared,
+            [](auto& c) { c.push_back(std::make_shared<Particle>()); }, deref);
+        auto t_hive_shared = workload(
+            hive_of_shared,
+            [](auto& c) { c.insert(std::make_shared<Particle>()); }, deref);
+        auto t_hive = workload(
+            hive_of_values, [](auto& c) { c.emplace(); },
+            [](Particle& p) -> Particle& { return p; });
+        std::println("list<shared_ptr>: {:.2f} ms | hive<shared_ptr>: {:.2f} "
+                     "ms | hive<Particle>: {:.2f} ms",
+                     t_list, t_hive_shared, t_hive);
+    };
 };
 }  // namespace item_42
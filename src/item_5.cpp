@@ -7,6 +7,8 @@
 #include <unordered_map>
 #include <vector>
 
+#include "flat_hash_map.hpp"
+
 namespace item_5 {
 using boost::typeindex::type_id_with_cvr;
 using std::cout;
@@ -100,5 +102,16 @@ void main() {
         // faça alguma operação com 'p'
         // ...
     }
+    // O mesmo vale para 'flat_hash_map' (./flat_hash_map.hpp), cujos
+    // iteradores retornam pares de referências ('std::pair<const std::string&,
+    // int&>'): a conversão para 'std::pair<std::string, int>' copiaria cada
+    // chave. Como o par é um temporário, 'auto&' não compila, mas 'auto&&' e
+    // 'structured bindings' funcionam sem cópias:
+    flat_hash_map<std::string, int> fm;
+    for (auto&& [key, value] : fm) {
+        // ...
+        // faça alguma operação com 'key' e 'value'
+        // ...
+    }
 };
 }  // namespace item_5
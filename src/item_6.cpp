@@ -1,12 +1,17 @@
+#include <algorithm>
 #include <boost/type_index.hpp>
 #include <functional>
 #include <iostream>
 #include <memory>
 #include <print>
+#include <random>
 #include <ranges>
 #include <unordered_map>
 #include <vector>
 
+#include "bench.hpp"
+#include "dynamic_bitset.hpp"
+
 namespace item_6 {
 using boost::typeindex::type_id_with_cvr;
 using std::cout;
@@ -45,5 +50,70 @@ void main() {
     auto e1 = calc_epsilon();                      // tipo de e1: bool.
     float e2 = calc_epsilon();                     // tipo de e2: float.
     auto e3 = static_cast<float>(calc_epsilon());  // tipo de e3: float.
+
+    // Alternativamente, pode-se evitar a classe 'proxy' por completo:
+    // 'dynamic_bitset' (./dynamic_bitset.hpp) retorna 'bool' em 'operator[]'
+    // e a escrita é feita por métodos explícitos ('.set()', '.reset()'):
+    dynamic_bitset bs{true, false, false, true};
+    auto b1 = bs[3];  // tipo de b1: bool
+    cout << "auto b1 = bs[3]; tipo de b1: "
+         << type_id_with_cvr<decltype(b1)>().pretty_name() << endl;
+
+    {
+        // Máscaras de filtragem com 100'000'000 de bits: 'a & b & ~c',
+        // contagem dos bits ligados e iteração sobre as suas posições.
+        cout << endl;
+        constexpr std::size_t n = 100'000'000;
+        std::mt19937_64 rng{42};
+        dynamic_bitset a(n), b(n), c(n);
+        for (auto* m : {&a, &b, &c}) {
+            for (auto& w : m->words()) w = rng();
+            m->resize(n);  // zera os bits além de 'n'.
+        }
+        std::vector<bool> va(n), vb(n), vc(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            va[i] = a[i];
+            vb[i] = b[i];
+            vc[i] = c[i];
+        }
+
+        std::vector<bool> vr(n);
+        std::size_t v_count = 0, v_sum = 0;
+        auto v_filter = time_ms([&] {
+            for (std::size_t i = 0; i < n; ++i) {
+                vr[i] = va[i] && vb[i] && !vc[i];
+            }
+        });
+        auto v_count_t =
+            time_ms([&] { v_count = std::count(vr.begin(), vr.end(), true); });
+        auto v_iter = time_ms([&] {
+            for (std::size_t i = 0; i < n; ++i) {
+                if (vr[i]) v_sum += i;
+            }
+        });
+
+        dynamic_bitset r;
+        std::size_t d_count = 0, d_sum = 0;
+        auto d_filter = time_ms([&] {
+            r = a;
+            r &= b;
+            r.and_not(c);
+        });
+        auto d_count_t = time_ms([&] { d_count = r.count(); });
+        auto d_iter = time_ms([&] {
+            for (auto i : r.set_bits()) d_sum += i;
+        });
+        do_not_optimize(v_sum + d_sum);
+
+        std::println("bits selecionados: {} (vector<bool>) | {} "
+                     "(dynamic_bitset)",
+                     v_count, d_count);
+        std::println("vector<bool>:   filtro {:.2f} ms | contagem {:.2f} ms | "
+                     "iteração {:.2f} ms",
+                     v_filter, v_count_t, v_iter);
+        std::println("dynamic_bitset: filtro {:.2f} ms | contagem {:.2f} ms | "
+                     "iteração {:.2f} ms",
+                     d_filter, d_count_t, d_iter);
+    };
 };
 }  // namespace item_6
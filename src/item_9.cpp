@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <atomic>
 #include <boost/type_index.hpp>
 #include <functional>
@@ -5,11 +6,15 @@
 #include <list>
 #include <memory>
 #include <print>
+#include <random>
 #include <ranges>
 #include <type_traits>
 #include <unordered_map>
 #include <vector>
 
+#include "bench.hpp"
+#include "flat_hash_map.hpp"
+
 namespace item_9 {
 using boost::typeindex::type_id_with_cvr;
 using std::cout;
@@ -120,6 +125,9 @@ void main() {
         UPtrMapSS1;  // existe alternativa melhor ('using');
     using UPtrMapSS2 =
         std::unique_ptr<std::unordered_map<std::string, std::string>>;
+    // tabela 'hash' sem um nó alocado por elemento (./flat_hash_map.hpp):
+    using UPtrFlatMapSS =
+        std::unique_ptr<flat_hash_map<std::string, std::string>>;
     // comparação entre 'typedef' e 'type alias' para ponteiro de funções:
     typedef void (*FP1)(int, const std::string&);
     using FP2 = void (*)(int, const std::string&);
@@ -157,5 +165,85 @@ void main() {
     // 'template structs'. Já a nova sintaxe, com o posfixo '_t' ao fim do nome
     // da transformação: 'std::transformation_t<T>', faz uso do mecanismo de
     // 'alias', definido pela standard C++14.
+
+    {
+        // Comparação entre 'std::unordered_map<string, int>' e
+        // 'flat_hash_map<string, int>' com 1'000'000 de chaves:
+        cout << endl;
+        constexpr int n = 1'000'000;
+        vector<string> keys, missing;
+        keys.reserve(n);
+        missing.reserve(n);
+        std::mt19937_64 rng{42};
+        for (int i = 0; i < n; ++i) {
+            keys.push_back("user:" + to_string(rng()));
+            missing.push_back("nobody:" + to_string(rng()));
+        }
+        std::shuffle(keys.begin(), keys.end(), rng);
+
+        std::unordered_map<string, int> um;
+        flat_hash_map<string, int> fm;
+        auto compare = [](const char* test, auto run_um, auto run_fm) {
+            auto t_um = time_ms(run_um);
+            auto t_fm = time_ms(run_fm);
+            std::println("{:<34} unordered_map {:>8.2f} ms | "
+                         "flat_hash_map {:>8.2f} ms",
+                         test, t_um, t_fm);
+        };
+        std::size_t acc = 0;
+        compare(
+            "inserção:",
+            [&] {
+                for (int i = 0; i < n; ++i) um.emplace(keys[i], i);
+            },
+            [&] {
+                for (int i = 0; i < n; ++i) fm.try_emplace(keys[i], i);
+            });
+        compare(
+            "busca (std::string):",
+            [&] {
+                for (const auto& k : keys) acc += um.find(k)->second;
+            },
+            [&] {
+                for (const auto& k : keys) acc += fm.find(k)->second;
+            });
+        // Sem 'hash' transparente, 'unordered_map' exige uma 'std::string'
+        // temporária para cada busca com 'std::string_view':
+        compare(
+            "busca (std::string_view):",
+            [&] {
+                for (std::string_view k : keys) {
+                    acc += um.find(string(k))->second;
+                }
+            },
+            [&] {
+                for (std::string_view k : keys) acc += fm.find(k)->second;
+            });
+        compare(
+            "busca sem sucesso:",
+            [&] {
+                for (const auto& k : missing) acc += um.contains(k);
+            },
+            [&] {
+                for (const auto& k : missing) acc += fm.contains(k);
+            });
+        compare(
+            "iteração:",
+            [&] {
+                for (const auto& [k, v] : um) acc += v;
+            },
+            [&] {
+                for (auto&& [k, v] : fm) acc += v;
+            });
+        compare(
+            "remoção de metade das chaves:",
+            [&] {
+                for (int i = 0; i < n; i += 2) um.erase(keys[i]);
+            },
+            [&] {
+                for (int i = 0; i < n; i += 2) fm.erase(keys[i]);
+            });
+        do_not_optimize(acc);
+    };
 };
 }  // namespace item_9
@@ -0,0 +1,381 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+// Leitura de arquivos de captura ('pcap' e 'pcapng') sem cópias.
+//
+// O arquivo é mapeado em memória ('mmap') e os pacotes são percorridos como
+// 'views' ('std::span') sobre o próprio mapeamento: não há leituras para
+// 'buffers' intermediários, cópias nem alocações por pacote. O 'kernel' é
+// informado do acesso sequencial ('madvise(MADV_SEQUENTIAL)'), o que aumenta a
+// leitura antecipada do disco e permite descartar páginas já lidas, e cada
+// avanço do iterador solicita ao processador a busca antecipada ('prefetch')
+// dos bytes 'prefetch_distance' à frente.
+//
+// Os campos de 'item_30::IPv4Header' são expostos por 'IPv4HeaderView', que
+// os lê diretamente dos bytes em ordem de rede.
+
+// 'view' não proprietária sobre um cabeçalho IPv4 (pelo menos 20 bytes).
+class IPv4HeaderView {
+   public:
+    explicit IPv4HeaderView(const std::byte* p) : p{p} {}
+
+    std::uint8_t version() const { return byte(0) >> 4; }
+    std::uint8_t IHL() const { return byte(0) & 0x0F; }
+    std::uint8_t DSCP() const { return byte(1) >> 2; }
+    std::uint8_t ECN() const { return byte(1) & 0x03; }
+    std::uint16_t total_length() const {
+        return static_cast<std::uint16_t>(byte(2) << 8 | byte(3));
+    }
+    const std::byte* data() const { return p; }
+
+   private:
+    std::uint8_t byte(std::size_t i) const {
+        return std::to_integer<std::uint8_t>(p[i]);
+    }
+
+    const std::byte* p;
+};
+
+struct pcap_packet {
+    std::int64_t timestamp_ns;        // desde a época Unix.
+    std::uint32_t original_length;    // comprimento original no 'link'.
+    std::uint16_t link_type;          // 'LINKTYPE_*' da interface.
+    std::span<const std::byte> data;  // bytes capturados (no mapeamento).
+
+    // Cabeçalho IPv4 do pacote, caso este transporte IPv4 (Ethernet, com ou
+    // sem VLAN, 'raw IP', 'Linux cooked' ou 'loopback BSD').
+    std::optional<IPv4HeaderView> ipv4() const {
+        std::size_t offset = 0;
+        switch (link_type) {
+            case 0:  // LINKTYPE_NULL: família do protocolo (4 bytes).
+                if (data.size() < 4 || !(u8(0) == 2 || u8(3) == 2)) return {};
+                offset = 4;
+                break;
+            case 1: {  // LINKTYPE_ETHERNET.
+                offset = 12;
+                // Etiquetas de VLAN (802.1Q e 802.1ad).
+                while (data.size() >= offset + 2 &&
+                       (be16(offset) == 0x8100 || be16(offset) == 0x88A8)) {
+                    offset += 4;
+                }
+                if (data.size() < offset + 2 || be16(offset) != 0x0800) {
+                    return {};
+                }
+                offset += 2;
+                break;
+            }
+            case 101:  // LINKTYPE_RAW.
+            case 228:  // LINKTYPE_IPV4.
+                break;
+            case 113:  // LINKTYPE_LINUX_SLL.
+                if (data.size() < 16 || be16(14) != 0x0800) return {};
+                offset = 16;
+                break;
+            default:
+                return {};
+        }
+        if (data.size() < offset + 20 || (u8(offset) >> 4) != 4) return {};
+        return IPv4HeaderView{data.data() + offset};
+    }
+
+   private:
+    std::uint8_t u8(std::size_t i) const {
+        return std::to_integer<std::uint8_t>(data[i]);
+    }
+    std::uint16_t be16(std::size_t i) const {
+        return static_cast<std::uint16_t>(u8(i) << 8 | u8(i + 1));
+    }
+};
+
+// Mapeamento somente leitura de um arquivo inteiro.
+class mapped_file {
+   public:
+    explicit mapped_file(const std::filesystem::path& path) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) throw_errno("open");
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw_errno("fstat");
+        }
+        length = static_cast<std::size_t>(st.st_size);
+        if (length > 0) {
+            void* p = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd);
+                throw_errno("mmap");
+            }
+            addr = static_cast<const std::byte*>(p);
+            // Apenas uma dica para o 'kernel'; falhas podem ser ignoradas.
+            ::madvise(p, length, MADV_SEQUENTIAL);
+        }
+        ::close(fd);  // o mapeamento permanece válido.
+    }
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+    mapped_file(mapped_file&& o) noexcept
+        : addr{std::exchange(o.addr, nullptr)},
+          length{std::exchange(o.length, 0)} {}
+    mapped_file& operator=(mapped_file&& o) noexcept {
+        std::swap(addr, o.addr);
+        std::swap(length, o.length);
+        return *this;
+    }
+    ~mapped_file() {
+        if (addr) ::munmap(const_cast<std::byte*>(addr), length);
+    }
+
+    std::span<const std::byte> bytes() const { return {addr, length}; }
+
+   private:
+    [[noreturn]] static void throw_errno(const char* what) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    const std::byte* addr{nullptr};
+    std::size_t length{0};
+};
+
+// Leitor de arquivos 'pcap' (microssegundos ou nanossegundos, em qualquer
+// ordem de bytes) e 'pcapng' (blocos 'Enhanced Packet' e 'Simple Packet', em
+// qualquer número de seções e interfaces). É um 'input_range' de
+// 'pcap_packet'; apenas uma iteração deve estar ativa por vez. Um registro
+// final truncado (eg, captura interrompida) encerra a iteração.
+class pcap_reader {
+   public:
+    explicit pcap_reader(const std::filesystem::path& path,
+                         std::size_t prefetch_distance = 1024)
+        : file{path}, prefetch_distance{prefetch_distance} {
+        auto b = file.bytes();
+        if (b.size() < 4) {
+            throw std::runtime_error("pcap_reader: arquivo curto.");
+        }
+        auto magic = load<std::uint32_t>(b.data(), false);
+        switch (magic) {
+            case 0xA1B2C3D4: format = kind::pcap; break;
+            case 0xA1B23C4D: format = kind::pcap; nanoseconds = true; break;
+            case 0xD4C3B2A1: format = kind::pcap; swapped = true; break;
+            case 0x4D3CB2A1:
+                format = kind::pcap;
+                swapped = nanoseconds = true;
+                break;
+            case 0x0A0D0D0A: format = kind::pcapng; break;
+            default:
+                throw std::runtime_error("pcap_reader: formato desconhecido.");
+        }
+        if (format == kind::pcap) {
+            if (b.size() < 24) {
+                throw std::runtime_error("pcap_reader: cabeçalho truncado.");
+            }
+            pcap_link_type = static_cast<std::uint16_t>(
+                load<std::uint32_t>(b.data() + 20, swapped));
+        }
+    }
+
+    class iterator {
+       public:
+        using value_type = pcap_packet;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        explicit iterator(pcap_reader* r) : r{r} {
+            pos = r->format == kind::pcap ? 24 : 0;
+            ++*this;
+        }
+
+        const pcap_packet& operator*() const { return current; }
+        const pcap_packet* operator->() const { return &current; }
+
+        iterator& operator++() {
+            auto b = r->file.bytes();
+            if (pos + r->prefetch_distance < b.size()) {
+                __builtin_prefetch(b.data() + pos + r->prefetch_distance);
+            }
+            done = !(r->format == kind::pcap ? r->next_pcap(pos, current)
+                                             : r->next_pcapng(pos, current));
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+
+        bool operator==(std::default_sentinel_t) const { return done; }
+
+       private:
+        pcap_reader* r{nullptr};
+        std::size_t pos{0};
+        pcap_packet current{};
+        bool done{true};
+    };
+
+    iterator begin() {
+        interfaces.clear();
+        return iterator{this};
+    }
+    std::default_sentinel_t end() { return {}; }
+
+    // Apenas os cabeçalhos IPv4 dos pacotes que os possuem.
+    auto ipv4_headers() {
+        auto to_header = [](const pcap_packet& p) { return p.ipv4(); };
+        auto has_header = [](const auto& h) { return h.has_value(); };
+        return *this | std::views::transform(to_header) |
+               std::views::filter(has_header) |
+               std::views::transform([](const auto& h) { return *h; });
+    }
+
+   private:
+    enum class kind { pcap, pcapng };
+
+    struct interface {
+        std::uint16_t link_type;
+        bool binary_resolution;  // '2^-exponent' ao invés de '10^-exponent'.
+        std::uint8_t exponent;
+    };
+
+    template <typename T>
+    static T load(const std::byte* p, bool swap) {
+        T v;
+        std::memcpy(&v, p, sizeof(T));
+        return swap ? std::byteswap(v) : v;
+    }
+
+    bool next_pcap(std::size_t& pos, pcap_packet& out) const {
+        auto b = file.bytes();
+        if (b.size() - pos < 16) return false;
+        const std::byte* h = b.data() + pos;
+        auto sec = load<std::uint32_t>(h, swapped);
+        auto frac = load<std::uint32_t>(h + 4, swapped);
+        auto captured = load<std::uint32_t>(h + 8, swapped);
+        if (b.size() - pos - 16 < captured) return false;
+        out.timestamp_ns = std::int64_t{sec} * 1'000'000'000 +
+                           std::int64_t{frac} * (nanoseconds ? 1 : 1000);
+        out.original_length = load<std::uint32_t>(h + 12, swapped);
+        out.link_type = pcap_link_type;
+        out.data = b.subspan(pos + 16, captured);
+        pos += 16 + captured;
+        return true;
+    }
+
+    bool next_pcapng(std::size_t& pos, pcap_packet& out) {
+        auto b = file.bytes();
+        while (b.size() - pos >= 12) {
+            const std::byte* blk = b.data() + pos;
+            auto type = load<std::uint32_t>(blk, false);
+            if (type == 0x0A0D0D0A) {
+                // 'Section Header Block': define a ordem de bytes da seção.
+                auto bom = load<std::uint32_t>(blk + 8, false);
+                if (bom == 0x1A2B3C4D) {
+                    swapped = false;
+                } else if (bom == 0x4D3C2B1A) {
+                    swapped = true;
+                } else {
+                    return false;
+                }
+                interfaces.clear();
+            }
+            auto length = load<std::uint32_t>(blk + 4, swapped);
+            if (length < 12 || length % 4 != 0 || b.size() - pos < length) {
+                return false;
+            }
+            auto body = b.subspan(pos + 8, length - 12);
+            pos += length;
+            switch (load<std::uint32_t>(blk, swapped)) {
+                case 1:  // 'Interface Description Block'.
+                    if (body.size() >= 8) interfaces.push_back(parse_idb(body));
+                    break;
+                case 6:  // 'Enhanced Packet Block'.
+                    if (parse_epb(body, out)) return true;
+                    break;
+                case 3:  // 'Simple Packet Block' (interface 0, sem horário).
+                    if (body.size() >= 4 && !interfaces.empty()) {
+                        auto orig = load<std::uint32_t>(body.data(), swapped);
+                        auto captured =
+                            std::min<std::size_t>(orig, body.size() - 4);
+                        out = {0, orig, interfaces[0].link_type,
+                               body.subspan(4, captured)};
+                        return true;
+                    }
+                    break;
+                default:  // demais blocos são ignorados.
+                    break;
+            }
+        }
+        return false;
+    }
+
+    interface parse_idb(std::span<const std::byte> body) const {
+        interface itf{load<std::uint16_t>(body.data(), swapped), false, 6};
+        // Opções: código (2 bytes), comprimento (2 bytes), valor alinhado a
+        // 4 bytes. 'if_tsresol' (código 9) define a resolução dos
+        // 'timestamps'.
+        std::size_t i = 8;
+        while (body.size() - i >= 4) {
+            auto code = load<std::uint16_t>(body.data() + i, swapped);
+            auto len = load<std::uint16_t>(body.data() + i + 2, swapped);
+            if (code == 0 || body.size() - i - 4 < len) break;
+            if (code == 9 && len >= 1) {
+                auto v = std::to_integer<std::uint8_t>(body[i + 4]);
+                itf.binary_resolution = v & 0x80;
+                itf.exponent = v & 0x7F;
+            }
+            i += 4 + ((len + 3u) & ~3u);
+        }
+        return itf;
+    }
+
+    bool parse_epb(std::span<const std::byte> body, pcap_packet& out) const {
+        if (body.size() < 20) return false;
+        auto id = load<std::uint32_t>(body.data(), swapped);
+        if (id >= interfaces.size()) return false;
+        const interface& itf = interfaces[id];
+        auto ts = std::uint64_t{load<std::uint32_t>(body.data() + 4, swapped)}
+                      << 32 |
+                  load<std::uint32_t>(body.data() + 8, swapped);
+        auto captured = load<std::uint32_t>(body.data() + 12, swapped);
+        if (body.size() - 20 < captured) return false;
+        out.timestamp_ns = to_ns(ts, itf);
+        out.original_length = load<std::uint32_t>(body.data() + 16, swapped);
+        out.link_type = itf.link_type;
+        out.data = body.subspan(20, captured);
+        return true;
+    }
+
+    static std::int64_t to_ns(std::uint64_t ts, const interface& itf) {
+        if (itf.binary_resolution) {
+            return static_cast<std::int64_t>(
+                (static_cast<unsigned __int128>(ts) * 1'000'000'000) >>
+                itf.exponent);
+        }
+        std::uint64_t scale = 1;
+        for (int e = itf.exponent; e < 9; ++e) scale *= 10;
+        for (int e = 9; e < itf.exponent; ++e) ts /= 10;
+        return static_cast<std::int64_t>(ts * scale);
+    }
+
+    mapped_file file;
+    std::size_t prefetch_distance;
+    kind format{kind::pcap};
+    bool swapped{false};
+    bool nanoseconds{false};
+    std::uint16_t pcap_link_type{0};
+    std::vector<interface> interfaces;  // interfaces da seção 'pcapng' atual.
+};
@@ -0,0 +1,390 @@
+#pragma once
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "trivially_relocatable.hpp"
+
+// 'small_vector<T, N>': container contíguo com a mesma interface de
+// 'std::vector<T>', porém com os primeiros 'N' elementos armazenados no
+// próprio objeto. Somente quando a capacidade interna é excedida os elementos
+// são transferidos para a 'heap', tal qual um 'std::vector'.
+//
+// Útil para containers que na grande maioria das vezes possuem poucos
+// elementos (eg, 'Widget::foos' do item_41), evitando alocações. Em
+// contrapartida, enquanto os elementos estiverem no 'buffer' interno não há
+// ponteiro a ser transferido: mover o 'small_vector' exige mover os elementos
+// um a um (O(n)).
+template <typename T, std::size_t N, typename Alloc = std::allocator<T>>
+class small_vector {
+    static_assert(N > 0, "'small_vector' precisa de capacidade interna.");
+    using traits = std::allocator_traits<Alloc>;
+
+   public:
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = T*;
+    using const_iterator = const T*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    static constexpr size_type inline_capacity = N;
+
+    // Construtores:
+    small_vector() noexcept(noexcept(Alloc())) = default;
+    explicit small_vector(const Alloc& a) noexcept : alloc{a} {}
+    explicit small_vector(size_type n, const Alloc& a = Alloc()) : alloc{a} {
+        resize(n);
+    }
+    small_vector(size_type n, const T& value, const Alloc& a = Alloc())
+        : alloc{a} {
+        assign(n, value);
+    }
+    template <std::input_iterator It>
+    small_vector(It first, It last, const Alloc& a = Alloc()) : alloc{a} {
+        assign(first, last);
+    }
+    small_vector(std::initializer_list<T> il, const Alloc& a = Alloc())
+        : alloc{a} {
+        assign(il.begin(), il.end());
+    }
+    small_vector(const small_vector& o)
+        : alloc{traits::select_on_container_copy_construction(o.alloc)} {
+        assign(o.begin(), o.end());
+    }
+    small_vector(small_vector&& o) noexcept(
+        std::is_nothrow_move_constructible_v<T>)
+        : alloc{std::move(o.alloc)} {
+        steal(o);
+    }
+    ~small_vector() {
+        clear();
+        release();
+    }
+
+    small_vector& operator=(const small_vector& o) {
+        if (this != &o) assign(o.begin(), o.end());
+        return *this;
+    }
+    // Como em 'std::vector', o alocador é substituído apenas quando
+    // 'propagate_on_container_move_assignment'. Caso contrário, o bloco da
+    // 'heap' de 'o' só pode ser assumido se 'alloc' for capaz de liberá-lo
+    // ('alloc == o.alloc'); senão, os elementos são movidos um a um.
+    small_vector& operator=(small_vector&& o) noexcept(
+        std::is_nothrow_move_constructible_v<T> &&
+        (traits::propagate_on_container_move_assignment::value ||
+         traits::is_always_equal::value)) {
+        if (this != &o) {
+            clear();
+            if constexpr (traits::propagate_on_container_move_assignment::
+                              value) {
+                release();
+                alloc = std::move(o.alloc);
+            } else if constexpr (!traits::is_always_equal::value) {
+                if (alloc != o.alloc) {
+                    reserve(o.size_);
+                    for (auto& e : o) unchecked_emplace_back(std::move(e));
+                    o.clear();
+                    return *this;
+                }
+                release();
+            } else {
+                release();
+            }
+            steal(o);
+        }
+        return *this;
+    }
+    small_vector& operator=(std::initializer_list<T> il) {
+        assign(il.begin(), il.end());
+        return *this;
+    }
+
+    void assign(size_type n, const T& value) {
+        clear();
+        reserve(n);
+        for (size_type i = 0; i < n; ++i) unchecked_emplace_back(value);
+    }
+    template <std::input_iterator It>
+    void assign(It first, It last) {
+        clear();
+        if constexpr (std::forward_iterator<It>) {
+            reserve(static_cast<size_type>(std::distance(first, last)));
+        }
+        for (; first != last; ++first) emplace_back(*first);
+    }
+    void assign(std::initializer_list<T> il) { assign(il.begin(), il.end()); }
+
+    allocator_type get_allocator() const { return alloc; }
+
+    // Acesso aos elementos:
+    reference at(size_type i) {
+        if (i >= size_) throw std::out_of_range("small_vector::at");
+        return data_[i];
+    }
+    const_reference at(size_type i) const {
+        if (i >= size_) throw std::out_of_range("small_vector::at");
+        return data_[i];
+    }
+    reference operator[](size_type i) { return data_[i]; }
+    const_reference operator[](size_type i) const { return data_[i]; }
+    reference front() { return data_[0]; }
+    const_reference front() const { return data_[0]; }
+    reference back() { return data_[size_ - 1]; }
+    const_reference back() const { return data_[size_ - 1]; }
+    T* data() noexcept { return data_; }
+    const T* data() const noexcept { return data_; }
+
+    // Iteradores:
+    iterator begin() noexcept { return data_; }
+    iterator end() noexcept { return data_ + size_; }
+    const_iterator begin() const noexcept { return data_; }
+    const_iterator end() const noexcept { return data_ + size_; }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+    reverse_iterator rbegin() noexcept { return reverse_iterator{end()}; }
+    reverse_iterator rend() noexcept { return reverse_iterator{begin()}; }
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator{end()};
+    }
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator{begin()};
+    }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend() const noexcept { return rend(); }
+
+    // Capacidade:
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+    size_type max_size() const noexcept {
+        return std::min<size_type>(traits::max_size(alloc),
+                                   std::numeric_limits<difference_type>::max());
+    }
+    size_type capacity() const noexcept { return capacity_; }
+    // Indica se os elementos ainda estão no 'buffer' interno.
+    bool is_inline() const noexcept { return data_ == inline_data(); }
+
+    void reserve(size_type n) {
+        if (n > capacity_) reallocate(n);
+    }
+    void shrink_to_fit() {
+        if (is_inline() || size_ == capacity_) return;
+        reallocate(size_);
+    }
+
+    // Modificadores:
+    void clear() noexcept {
+        std::destroy_n(data_, size_);
+        size_ = 0;
+    }
+
+    iterator insert(const_iterator pos, const T& value) {
+        return emplace(pos, value);
+    }
+    iterator insert(const_iterator pos, T&& value) {
+        return emplace(pos, std::move(value));
+    }
+    iterator insert(const_iterator pos, size_type n, const T& value) {
+        auto idx = pos - begin();
+        auto old_size = size_;
+        if (size_ + n > capacity_) {
+            // 'value' pode referenciar um elemento do próprio container.
+            T tmp(value);
+            reserve(std::max(size_ + n, grown_capacity()));
+            for (size_type i = 0; i < n; ++i) unchecked_emplace_back(tmp);
+        } else {
+            for (size_type i = 0; i < n; ++i) unchecked_emplace_back(value);
+        }
+        std::rotate(begin() + idx, begin() + old_size, end());
+        return begin() + idx;
+    }
+    template <std::input_iterator It>
+    iterator insert(const_iterator pos, It first, It last) {
+        auto idx = pos - begin();
+        auto old_size = size_;
+        for (; first != last; ++first) emplace_back(*first);
+        std::rotate(begin() + idx, begin() + old_size, end());
+        return begin() + idx;
+    }
+    iterator insert(const_iterator pos, std::initializer_list<T> il) {
+        return insert(pos, il.begin(), il.end());
+    }
+
+    template <typename... Args>
+    iterator emplace(const_iterator pos, Args&&... args) {
+        auto idx = pos - begin();
+        if (pos == end()) {
+            emplace_back(std::forward<Args>(args)...);
+        } else {
+            // Insere no fim e rotaciona até a posição desejada.
+            emplace_back(std::forward<Args>(args)...);
+            std::rotate(begin() + idx, end() - 1, end());
+        }
+        return begin() + idx;
+    }
+
+    iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+    iterator erase(const_iterator first, const_iterator last) {
+        auto f = begin() + (first - cbegin());
+        auto l = begin() + (last - cbegin());
+        if (f != l) {
+            auto new_end = std::move(l, end(), f);
+            std::destroy(new_end, end());
+            size_ -= static_cast<size_type>(l - f);
+        }
+        return f;
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    template <typename... Args>
+    reference emplace_back(Args&&... args) {
+        if (size_ == capacity_) {
+            // 'args' pode referenciar um elemento do próprio container, que
+            // deixaria de ser válido após a realocação:
+            T tmp(std::forward<Args>(args)...);
+            reallocate(grown_capacity());
+            return unchecked_emplace_back(std::move(tmp));
+        }
+        return unchecked_emplace_back(std::forward<Args>(args)...);
+    }
+
+    void pop_back() { traits::destroy(alloc, data_ + --size_); }
+
+    void resize(size_type n) {
+        if (n < size_) {
+            erase(begin() + n, end());
+        } else {
+            reserve(n);
+            while (size_ < n) unchecked_emplace_back();
+        }
+    }
+    void resize(size_type n, const T& value) {
+        if (n < size_) {
+            erase(begin() + n, end());
+        } else {
+            reserve(n);
+            while (size_ < n) unchecked_emplace_back(value);
+        }
+    }
+
+    void swap(small_vector& o) noexcept(
+        std::is_nothrow_move_constructible_v<T>) {
+        small_vector tmp{std::move(o)};
+        o = std::move(*this);
+        *this = std::move(tmp);
+    }
+    friend void swap(small_vector& a, small_vector& b) noexcept(
+        noexcept(a.swap(b))) {
+        a.swap(b);
+    }
+
+    friend bool operator==(const small_vector& a, const small_vector& b) {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end());
+    }
+    friend auto operator<=>(const small_vector& a, const small_vector& b) {
+        return std::lexicographical_compare_three_way(a.begin(), a.end(),
+                                                      b.begin(), b.end());
+    }
+
+   private:
+    T* inline_data() noexcept {
+        return reinterpret_cast<T*>(storage);
+    }
+    const T* inline_data() const noexcept {
+        return reinterpret_cast<const T*>(storage);
+    }
+
+    size_type grown_capacity() const { return std::max(capacity_ * 2, N); }
+
+    template <typename... Args>
+    reference unchecked_emplace_back(Args&&... args) {
+        traits::construct(alloc, data_ + size_, std::forward<Args>(args)...);
+        return data_[size_++];
+    }
+
+    // Transfere 'n' elementos de 'from' para a região não inicializada 'to',
+    // destruindo os originais.
+    static void relocate(T* from, size_type n, T* to) {
+        if constexpr (is_trivially_relocatable_v<T>) {
+            if (n) std::memcpy(static_cast<void*>(to), from, n * sizeof(T));
+        } else {
+            std::uninitialized_move_n(from, n, to);
+            std::destroy_n(from, n);
+        }
+    }
+
+    // Passa a armazenar os elementos num bloco da 'heap' com capacidade 'n'
+    // (ou no 'buffer' interno, caso 'n <= N' durante '.shrink_to_fit()').
+    void reallocate(size_type n) {
+        T* target = n <= N ? inline_data() : traits::allocate(alloc, n);
+        if (target == data_) return;
+        if constexpr (!is_trivially_relocatable_v<T> &&
+                      !std::is_nothrow_move_constructible_v<T>) {
+            // Regras de 'std::move_if_noexcept': garantia forte de exceção
+            // (cópia, e só depois destruição) quando 'T' é copiável; tipos
+            // 'move-only' são movidos, com apenas a garantia básica.
+            try {
+                if constexpr (std::is_copy_constructible_v<T>) {
+                    std::uninitialized_copy_n(data_, size_, target);
+                } else {
+                    std::uninitialized_move_n(data_, size_, target);
+                }
+            } catch (...) {
+                if (target != inline_data()) {
+                    traits::deallocate(alloc, target, n);
+                }
+                throw;
+            }
+            std::destroy_n(data_, size_);
+        } else {
+            relocate(data_, size_, target);
+        }
+        release();
+        data_ = target;
+        capacity_ = n <= N ? N : n;
+    }
+
+    // Devolve o bloco da 'heap', caso exista (não destrói elementos).
+    void release() noexcept {
+        if (!is_inline()) traits::deallocate(alloc, data_, capacity_);
+        data_ = inline_data();
+        capacity_ = N;
+    }
+
+    // Assume o conteúdo de 'o' ('*this' não deve possuir elementos nem bloco
+    // da 'heap'). Blocos da 'heap' são transferidos; elementos no 'buffer'
+    // interno são movidos um a um.
+    void steal(small_vector& o) {
+        if (o.is_inline()) {
+            relocate(o.data_, o.size_, inline_data());
+            size_ = std::exchange(o.size_, 0);
+        } else {
+            data_ = std::exchange(o.data_, o.inline_data());
+            size_ = std::exchange(o.size_, 0);
+            capacity_ = std::exchange(o.capacity_, N);
+        }
+    }
+
+    [[no_unique_address]] Alloc alloc{};
+    T* data_{inline_data()};
+    size_type size_{0};
+    size_type capacity_{N};
+    alignas(T) std::byte storage[N * sizeof(T)];
+};
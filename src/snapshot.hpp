@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <utility>
+
+// 'snapshot<T>' implementa o padrão de publicação de 'snapshots' imutáveis
+// (similar ao RCU - 'read-copy-update') por meio de
+// 'std::atomic<std::shared_ptr<const T>>'.
+//
+// Leitores obtém, sem 'locks' explícitos, um 'std::shared_ptr<const T>' que
+// mantém vivo um estado consistente e imutável do objeto enquanto durar a
+// leitura. Escritores realizam uma cópia do estado atual, a modificam e então
+// publicam a nova versão atomicamente. Leitores que ainda possuem a versão
+// antiga não são afetados; esta será destruída assim que o último
+// 'std::shared_ptr' que a referencia for destruído.
+//
+// Adequado para dados do tipo 'read-mostly', como tabelas globais de consulta
+// que raramente são alteradas.
+//
+// Observação: cada '.load()' ainda incrementa/decrementa o contador de
+// referências do 'control block' compartilhado, o que gera disputa pela mesma
+// linha de cache quando há muitos leitores simultâneos. Para leituras em laços
+// críticos, 'snapshot<T>::reader' mantém uma cópia local do ponteiro e só
+// recarrega quando um escritor publica uma nova versão, de forma que o caminho
+// comum se resume à leitura de um contador de versão.
+template <typename T>
+class snapshot {
+   public:
+    using value_type = T;
+    using pointer = std::shared_ptr<const T>;
+
+    snapshot() : current(std::make_shared<const T>()) {}
+    explicit snapshot(T value)
+        : current(std::make_shared<const T>(std::move(value))) {}
+    // Apenas para containers ('T' com 'value_type'); como 'template', a
+    // declaração não é formada para os demais tipos (eg, 'snapshot<int>').
+    template <typename U = T>
+        requires requires { typename U::value_type; }
+    snapshot(std::initializer_list<typename U::value_type> il)
+        requires requires { T(il); }
+        : current(std::make_shared<const T>(il)) {}
+
+    snapshot(const snapshot&) = delete;
+    snapshot& operator=(const snapshot&) = delete;
+
+    // Obtém o 'snapshot' atual. O objeto referenciado é imutável e permanece
+    // válido enquanto o ponteiro retornado existir.
+    pointer load() const { return current.load(std::memory_order_acquire); }
+
+    // Publica uma versão completamente nova do objeto.
+    void publish(T value) {
+        current.store(std::make_shared<const T>(std::move(value)),
+                      std::memory_order_release);
+        version.fetch_add(1, std::memory_order_release);
+    }
+
+    // 'copy-modify-publish': copia o estado atual, aplica 'f' sobre a cópia e
+    // tenta publicá-la. Caso outro escritor tenha publicado uma versão nesse
+    // meio tempo, a operação é refeita sobre a versão mais recente, de forma
+    // que nenhuma atualização seja perdida.
+    template <typename F>
+    void update(F&& f) {
+        pointer expected = load();
+        for (;;) {
+            auto next = std::make_shared<T>(*expected);
+            f(*next);
+            pointer desired{std::move(next)};
+            if (current.compare_exchange_weak(expected, desired,
+                                              std::memory_order_acq_rel,
+                                              std::memory_order_acquire)) {
+                version.fetch_add(1, std::memory_order_release);
+                return;
+            }
+        }
+    }
+
+    // Leitor com 'cache' local do 'snapshot'. Cada 'thread' deve possuir o seu
+    // próprio 'reader'; a referência obtida por '*' ou '->' é válida até a
+    // próxima chamada de '.refresh()' (feita implicitamente pelos operadores).
+    class reader {
+       public:
+        explicit reader(const snapshot& s)
+            : src(&s),
+              seen(s.version.load(std::memory_order_acquire)),
+              cached(s.load()) {}
+
+        void refresh() {
+            auto v = src->version.load(std::memory_order_acquire);
+            if (v != seen) {
+                cached = src->load();
+                seen = v;
+            }
+        }
+        const T& operator*() {
+            refresh();
+            return *cached;
+        }
+        const T* operator->() { return &**this; }
+
+       private:
+        const snapshot* src;
+        std::uint64_t seen;
+        pointer cached;
+    };
+
+   private:
+    std::atomic<pointer> current;
+    std::atomic<std::uint64_t> version{0};
+};
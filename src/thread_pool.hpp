@@ -0,0 +1,387 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// 'Pool' de 'threads' com roubo de tarefas ('work stealing').
+//
+// 'std::async(std::launch::async, ...)' (como 'reall_async' do item_36) cria
+// uma nova 'thread' para cada tarefa, e o custo de criação e destruição da
+// 'thread' (dezenas de microssegundos) supera em muito o de tarefas pequenas.
+// Aqui, um número fixo de 'threads' ('workers') executa as tarefas
+// submetidas:
+//
+// - Cada 'worker' possui a sua própria fila dupla de Chase–Lev: o próprio
+//   'worker' insere e retira tarefas de uma extremidade sem 'locks' e sem
+//   disputa, enquanto os demais 'workers', quando ociosos, roubam tarefas da
+//   outra extremidade.
+// - Tarefas submetidas por 'threads' externas ao 'pool' entram numa fila
+//   global ('injection queue'), da qual os 'workers' retiram lotes para as
+//   suas filas locais. Tarefas submetidas de dentro de uma tarefa do 'pool'
+//   entram diretamente na fila local do 'worker'.
+// - 'workers' sem tarefas dormem ('std::atomic::wait') e são acordados apenas
+//   quando há 'workers' dormindo, de forma que a submissão não realize
+//   chamadas de sistema enquanto o 'pool' estiver ocupado.
+//
+// '.submit()' retorna um 'std::future', como 'std::async'. Diferentemente do
+// 'std::future' de 'std::async', a sua destruição não bloqueia até o término
+// da tarefa. '.post()' não cria o estado compartilhado do 'std::future': uma
+// exceção emitida pela tarefa termina o programa ('std::terminate'), como
+// ocorre com 'std::thread' (item_35).
+//
+// Uma tarefa não deve aguardar ('.get()', '.wait()') o resultado de outra
+// tarefa do mesmo 'pool': caso todos os 'workers' estejam aguardando, não há
+// quem execute as tarefas pendentes ('deadlock'). O destrutor aguarda a
+// execução de todas as tarefas pendentes.
+class thread_pool {
+    struct task {
+        virtual ~task() = default;
+        virtual void run() = 0;
+    };
+
+    template <typename F>
+    struct task_impl final : task {
+        explicit task_impl(F&& f) : f{std::move(f)} {}
+        void run() override { f(); }
+        F f;
+    };
+
+    // Fila dupla de Chase–Lev (na formulação de Lê, Pop, Cohen e Zappa
+    // Nardelli para o modelo de memória do C11). Apenas o dono executa
+    // '.push()' e '.pop()' (em 'bottom'); '.steal()' (em 'top') pode ser
+    // executado por qualquer 'thread'.
+    class work_deque {
+        struct ring {
+            explicit ring(std::size_t capacity)
+                : mask{capacity - 1},
+                  slots{std::make_unique<std::atomic<task*>[]>(capacity)} {}
+
+            task* get(std::int64_t i) const {
+                return slots[static_cast<std::size_t>(i) & mask].load(
+                    std::memory_order_relaxed);
+            }
+            void put(std::int64_t i, task* t) {
+                slots[static_cast<std::size_t>(i) & mask].store(
+                    t, std::memory_order_relaxed);
+            }
+
+            const std::size_t mask;
+            const std::unique_ptr<std::atomic<task*>[]> slots;
+        };
+
+       public:
+        explicit work_deque(std::size_t capacity = 256) {
+            rings.push_back(std::make_unique<ring>(capacity));
+            current.store(rings.back().get(), std::memory_order_relaxed);
+        }
+
+        // Tarefas não executadas (apenas no encerramento do 'pool').
+        ~work_deque() {
+            while (task* t = pop()) delete t;
+        }
+
+        void push(task* t) {
+            auto b = bottom.load(std::memory_order_relaxed);
+            auto tp = top.load(std::memory_order_acquire);
+            ring* r = current.load(std::memory_order_relaxed);
+            if (b - tp > static_cast<std::int64_t>(r->mask)) r = grow(r, tp, b);
+            r->put(b, t);
+            std::atomic_thread_fence(std::memory_order_release);
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+
+        task* pop() {
+            auto b = bottom.load(std::memory_order_relaxed) - 1;
+            ring* r = current.load(std::memory_order_relaxed);
+            bottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            auto t = top.load(std::memory_order_relaxed);
+            if (t > b) {
+                bottom.store(b + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            task* x = r->get(b);
+            if (t == b) {
+                // Último elemento: disputa com os 'steal' concorrentes.
+                if (!top.compare_exchange_strong(t, t + 1,
+                                                 std::memory_order_seq_cst,
+                                                 std::memory_order_relaxed)) {
+                    x = nullptr;
+                }
+                bottom.store(b + 1, std::memory_order_relaxed);
+            }
+            return x;
+        }
+
+        // Retorna 'nullptr' caso a fila esteja vazia ou caso outra 'thread'
+        // tenha retirado o elemento antes.
+        task* steal() {
+            auto t = top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            auto b = bottom.load(std::memory_order_acquire);
+            if (t >= b) return nullptr;
+            ring* r = current.load(std::memory_order_acquire);
+            task* x = r->get(t);
+            if (!top.compare_exchange_strong(t, t + 1,
+                                             std::memory_order_seq_cst,
+                                             std::memory_order_relaxed)) {
+                return nullptr;
+            }
+            return x;
+        }
+
+       private:
+        // Os arranjos antigos são mantidos até a destruição da fila, pois
+        // um 'steal' concorrente ainda pode estar lendo deles.
+        ring* grow(ring* old, std::int64_t t, std::int64_t b) {
+            auto next = std::make_unique<ring>((old->mask + 1) * 2);
+            for (auto i = t; i < b; ++i) next->put(i, old->get(i));
+            rings.push_back(std::move(next));
+            current.store(rings.back().get(), std::memory_order_release);
+            return rings.back().get();
+        }
+
+        // 'top' e 'bottom' em linhas de cache distintas, como em
+        // './async_logger.hpp'.
+        alignas(64) std::atomic<std::int64_t> top{0};
+        alignas(64) std::atomic<std::int64_t> bottom{0};
+        std::atomic<ring*> current{nullptr};
+        std::vector<std::unique_ptr<ring>> rings;
+    };
+
+    struct worker {
+        work_deque deque;
+        std::uint64_t rng;  // escolha das vítimas de roubo ('xorshift').
+        std::jthread thread;
+    };
+
+   public:
+    explicit thread_pool(std::size_t n_workers = default_size())
+        : workers(std::max<std::size_t>(n_workers, 1)) {
+        for (std::size_t i = 0; i < workers.size(); ++i) {
+            workers[i] = std::make_unique<worker>();
+            workers[i]->rng = 0x9E3779B97F4A7C15u * (i + 1);
+        }
+        // As 'threads' são iniciadas apenas após todos os 'workers' existirem,
+        // pois cada uma pode roubar das demais.
+        try {
+            for (std::size_t i = 0; i < workers.size(); ++i) {
+                workers[i]->thread = std::jthread{
+                    [this, i](std::stop_token st) { worker_loop(i, st); }};
+            }
+        } catch (...) {
+            // As 'threads' já iniciadas podem estar dormindo em 'signal', e o
+            // destrutor de 'std::jthread' apenas solicita a parada e aguarda.
+            stop_workers();
+            throw;
+        }
+    }
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    // Aguarda a execução das tarefas pendentes e encerra os 'workers'.
+    ~thread_pool() {
+        stop_workers();
+        for (task* t : global) delete t;
+    }
+
+    // Executa 'func(args...)' num dos 'workers'. Assim como em 'std::async',
+    // 'func' e 'args' são copiados (ou movidos) para a tarefa.
+    template <typename Func, typename... Args>
+    auto submit(Func&& func, Args&&... args) {
+        using R =
+            std::invoke_result_t<std::decay_t<Func>, std::decay_t<Args>...>;
+        std::promise<R> promise;
+        auto future = promise.get_future();
+        enqueue(make_task([promise = std::move(promise),
+                           f = std::forward<Func>(func),
+                           ... args = std::forward<Args>(args)]() mutable {
+            try {
+                if constexpr (std::is_void_v<R>) {
+                    std::invoke(std::move(f), std::move(args)...);
+                    promise.set_value();
+                } else {
+                    promise.set_value(
+                        std::invoke(std::move(f), std::move(args)...));
+                }
+            } catch (...) {
+                promise.set_exception(std::current_exception());
+            }
+        }));
+        return future;
+    }
+
+    // Como '.submit()', porém sem retorno.
+    template <typename Func, typename... Args>
+    void post(Func&& func, Args&&... args) {
+        enqueue(make_task([f = std::forward<Func>(func),
+                           ... args = std::forward<Args>(args)]() mutable {
+            std::invoke(std::move(f), std::move(args)...);
+        }));
+    }
+
+    std::size_t size() const noexcept { return workers.size(); }
+
+    // Um 'worker' por 'hardware thread'.
+    static std::size_t default_size() noexcept {
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+   private:
+    // Encerra e aguarda as 'threads' já iniciadas.
+    void stop_workers() noexcept {
+        for (auto& w : workers) w->thread.request_stop();
+        signal.fetch_add(1, std::memory_order_release);
+        signal.notify_all();
+        for (auto& w : workers) {
+            if (w->thread.joinable()) w->thread.join();
+        }
+    }
+
+    template <typename F>
+    static std::unique_ptr<task> make_task(F f) {
+        return std::make_unique<task_impl<F>>(std::move(f));
+    }
+
+    // 'worker' da 'thread' atual (caso pertença a algum 'pool').
+    struct worker_id {
+        const thread_pool* pool;
+        std::size_t index;
+    };
+    static worker_id& current_worker() {
+        thread_local worker_id id{nullptr, 0};
+        return id;
+    }
+
+    void enqueue(std::unique_ptr<task> t) {
+        auto& self = current_worker();
+        if (self.pool == this) {
+            workers[self.index]->deque.push(t.get());
+        } else {
+            std::scoped_lock lock{global_mutex};
+            global.push_back(t.get());
+            global_size.store(global.size(), std::memory_order_relaxed);
+        }
+        t.release();
+        wake_one();
+    }
+
+    // Em conjunto com '.park()': ou o produtor observa o 'worker' dormindo e
+    // o acorda, ou o 'worker' observa a nova tarefa antes de dormir.
+    void wake_one() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping.load(std::memory_order_relaxed) > 0) {
+            signal.fetch_add(1, std::memory_order_release);
+            signal.notify_one();
+        }
+    }
+
+    // Retira até 'global_batch' tarefas da fila global: a primeira é
+    // retornada e as demais vão para a fila local, e um 'worker' adormecido é
+    // acordado para roubá-las.
+    task* pop_global(worker& w) {
+        if (global_size.load(std::memory_order_relaxed) == 0) return nullptr;
+        task* first;
+        std::size_t n;
+        {
+            std::scoped_lock lock{global_mutex};
+            if (global.empty()) return nullptr;
+            first = global.front();
+            global.pop_front();
+            n = std::min(global.size(), global_batch);
+            for (std::size_t i = 0; i < n; ++i) {
+                w.deque.push(global.front());
+                global.pop_front();
+            }
+            global_size.store(global.size(), std::memory_order_relaxed);
+        }
+        if (n > 0) wake_one();
+        return first;
+    }
+
+    task* find_task(worker& w, std::size_t index) {
+        if (task* t = w.deque.pop()) return t;
+        if (task* t = pop_global(w)) return t;
+        w.rng ^= w.rng << 13;
+        w.rng ^= w.rng >> 7;
+        w.rng ^= w.rng << 17;
+        auto n = workers.size();
+        auto start = static_cast<std::size_t>(w.rng % n);
+        for (std::size_t k = 0; k < n; ++k) {
+            auto victim = (start + k) % n;
+            if (victim == index) continue;
+            if (task* t = workers[victim]->deque.steal()) return t;
+        }
+        return nullptr;
+    }
+
+    static void run(task* t) { std::unique_ptr<task>{t}->run(); }
+
+    // Dorme até a próxima submissão, a menos que haja uma tarefa disponível
+    // (retornada) ou que o 'pool' esteja sendo encerrado.
+    task* park(worker& w, std::size_t index, std::stop_token& st) {
+        sleeping.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto s = signal.load(std::memory_order_acquire);
+        task* t = find_task(w, index);
+        if (!t && !st.stop_requested()) {
+            signal.wait(s, std::memory_order_acquire);
+        }
+        sleeping.fetch_sub(1, std::memory_order_relaxed);
+        return t;
+    }
+
+    void worker_loop(std::size_t index, std::stop_token st) {
+        current_worker() = {this, index};
+        worker& w = *workers[index];
+        while (true) {
+            task* t = nullptr;
+            // Algumas tentativas antes de dormir, já que acordar custa uma
+            // chamada de sistema.
+            for (int spin = 0; !t && spin < spin_rounds; ++spin) {
+                t = find_task(w, index);
+                if (!t) std::this_thread::yield();
+            }
+            if (!t && st.stop_requested()) break;
+            if (!t) t = park(w, index, st);
+            if (t) run(t);
+        }
+    }
+
+    static constexpr std::size_t global_batch = 32;
+    static constexpr int spin_rounds = 64;
+
+    std::vector<std::unique_ptr<worker>> workers;
+    std::mutex global_mutex;
+    std::deque<task*> global;
+    std::atomic<std::size_t> global_size{0};
+    alignas(64) std::atomic<std::uint32_t> signal{0};
+    alignas(64) std::atomic<std::uint32_t> sleeping{0};
+};
+
+// 'pool' compartilhado pelo programa, com um 'worker' por 'hardware thread'.
+inline thread_pool& default_thread_pool() {
+    static thread_pool pool;
+    return pool;
+}
+
+// Substituto de 'reall_async' (item_36) que executa 'func' no
+// 'default_thread_pool()' ao invés de numa nova 'thread'.
+template <typename Func, typename... Args>
+auto pool_async(Func&& func, Args&&... args) {
+    return default_thread_pool().submit(std::forward<Func>(func),
+                                        std::forward<Args>(args)...);
+}
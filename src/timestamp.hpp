@@ -0,0 +1,159 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Fontes de 'timestamps' baratas para caminhos críticos (eg, 'log_and_add' dos
+// itens 26 e 27), onde 'std::chrono::system_clock::now()' (uma chamada via
+// vDSO seguida de conversões) pode custar mais do que a própria operação
+// registrada.
+//
+// Ambas seguem a interface de 'clocks' do 'std::chrono' ('rep', 'period',
+// 'duration', 'time_point', 'is_steady', 'now()') e fornecem '::to_sys()' e
+// '::from_sys()', de forma que 'std::chrono::clock_cast' possa convertê-las
+// para 'system_clock' (eg, para formatação com 'std::format').
+
+// 'Clock' baseado no contador de ciclos do processador ('rdtsc'). A leitura
+// crua ('::ticks()') custa poucos nanossegundos e pode ser armazenada
+// diretamente; a conversão para nanossegundos ('::from_ticks()') é feita
+// apenas quando necessária. A frequência do contador é calibrada contra
+// 'steady_clock' no primeiro uso (~10 ms). Assume-se um TSC invariante
+// (frequência constante e sincronizado entre núcleos), como em processadores
+// x86 modernos. Em outras arquiteturas, os 'ticks' são os nanossegundos de
+// 'steady_clock'.
+class tsc_clock {
+   public:
+    using rep = std::int64_t;
+    using period = std::nano;
+    using duration = std::chrono::duration<rep, period>;
+    using time_point = std::chrono::time_point<tsc_clock>;
+    static constexpr bool is_steady = true;
+
+    static std::uint64_t ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+    }
+
+    static time_point from_ticks(std::uint64_t t) {
+        const auto& c = calibration();
+        auto delta = static_cast<std::int64_t>(t - c.tsc0);
+        // Multiplicação em ponto fixo (32 bits fracionários).
+        auto ns = static_cast<std::int64_t>(
+            (static_cast<__int128>(delta) * c.mult) >> 32);
+        return time_point{duration{c.sys0 + ns}};
+    }
+
+    static time_point now() { return from_ticks(ticks()); }
+
+    // A época de 'tsc_clock' é a mesma de 'system_clock'. Como o contador não
+    // acompanha ajustes posteriores do relógio do sistema, as duas fontes
+    // podem divergir lentamente ao longo do tempo.
+    template <typename Duration>
+    static std::chrono::sys_time<Duration> to_sys(
+        const std::chrono::time_point<tsc_clock, Duration>& t) {
+        return std::chrono::sys_time<Duration>{t.time_since_epoch()};
+    }
+    template <typename Duration>
+    static std::chrono::time_point<tsc_clock, Duration> from_sys(
+        const std::chrono::sys_time<Duration>& t) {
+        return std::chrono::time_point<tsc_clock, Duration>{
+            t.time_since_epoch()};
+    }
+
+    // Frequência calibrada do contador ('ticks' por segundo).
+    static double frequency() {
+        return 1e9 * 4294967296.0 / static_cast<double>(calibration().mult);
+    }
+
+   private:
+    struct calibration_data {
+        std::uint64_t tsc0;  // leitura do contador no instante 'sys0'.
+        std::int64_t sys0;   // nanossegundos de 'system_clock' em 'tsc0'.
+        std::int64_t mult;   // nanossegundos por 'tick', com 32 bits frac.
+    };
+
+    static const calibration_data& calibration() {
+        static const calibration_data c = [] {
+            using namespace std::chrono;
+            auto s0 = steady_clock::now();
+            auto t0 = ticks();
+            auto sys0 = system_clock::now();
+            std::this_thread::sleep_for(10ms);
+            auto s1 = steady_clock::now();
+            auto t1 = ticks();
+            auto elapsed_ns = duration_cast<nanoseconds>(s1 - s0).count();
+            auto mult = static_cast<std::int64_t>(
+                (static_cast<__int128>(elapsed_ns) << 32) / (t1 - t0));
+            return calibration_data{
+                t0, duration_cast<nanoseconds>(sys0.time_since_epoch()).count(),
+                mult};
+        }();
+        return c;
+    }
+};
+
+// 'Clock' de baixa resolução: uma 'thread' de fundo atualiza um valor atômico
+// a cada 1 ms, e '::now()' apenas o lê (uma leitura de memória, sem chamadas
+// ao sistema). Adequado quando a precisão de milissegundos é suficiente. A
+// 'thread' é iniciada no primeiro uso e encerrada ao fim do programa.
+class coarse_clock {
+   public:
+    using rep = std::int64_t;
+    using period = std::nano;
+    using duration = std::chrono::duration<rep, period>;
+    using time_point = std::chrono::time_point<coarse_clock>;
+    static constexpr bool is_steady = false;
+
+    static constexpr std::chrono::milliseconds resolution{1};
+
+    static time_point now() {
+        return time_point{
+            duration{ticker().current.load(std::memory_order_relaxed)}};
+    }
+
+    template <typename Duration>
+    static std::chrono::sys_time<Duration> to_sys(
+        const std::chrono::time_point<coarse_clock, Duration>& t) {
+        return std::chrono::sys_time<Duration>{t.time_since_epoch()};
+    }
+    template <typename Duration>
+    static std::chrono::time_point<coarse_clock, Duration> from_sys(
+        const std::chrono::sys_time<Duration>& t) {
+        return std::chrono::time_point<coarse_clock, Duration>{
+            t.time_since_epoch()};
+    }
+
+   private:
+    struct updater {
+        updater()
+            : current{sys_now()}, thread{[this](std::stop_token st) {
+                  while (!st.stop_requested()) {
+                      std::this_thread::sleep_for(resolution);
+                      current.store(sys_now(), std::memory_order_relaxed);
+                  }
+              }} {}
+
+        static rep sys_now() {
+            return std::chrono::duration_cast<duration>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                .count();
+        }
+
+        std::atomic<rep> current;
+        std::jthread thread;
+    };
+
+    static updater& ticker() {
+        static updater u;
+        return u;
+    }
+};
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <memory>
+#include <type_traits>
+
+// Um tipo é 'trivialmente realocável' quando mover um objeto para um novo
+// endereço e destruir o original equivale a copiar os seus bytes ('memcpy')
+// e simplesmente esquecer o original. Containers podem então realocar os seus
+// elementos com 'memcpy'/'realloc' ao invés de 'move constructor' + destrutor
+// elemento a elemento.
+//
+// Todo tipo 'trivially copyable' satisfaz essa propriedade. Outros tipos
+// precisam ser marcados explicitamente, por especialização. Atenção: não é o
+// caso de 'std::string' na 'libstdc++', que mantém um ponteiro para o próprio
+// 'buffer' interno ('small string optimization').
+template <typename T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+template <typename T>
+struct is_trivially_relocatable<std::unique_ptr<T>> : std::true_type {};
+
+template <typename T>
+struct is_trivially_relocatable<std::shared_ptr<T>> : std::true_type {};
+
+template <typename T>
+inline constexpr bool is_trivially_relocatable_v =
+    is_trivially_relocatable<T>::value;
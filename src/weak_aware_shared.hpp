@@ -0,0 +1,103 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+// 'std::make_shared' realiza apenas 1 alocação, contendo tanto o 'control
+// block' quanto o objeto. A consequência (ver item_21) é que a memória do
+// objeto só pode ser devolvida quando o último 'std::weak_ptr' for destruído,
+// mesmo que o destrutor do objeto já tenha sido executado quando o último
+// 'std::shared_ptr' deixou de existir.
+//
+// Vale notar que apenas 'sizeof(T)' fica retido: para 'std::vector<int>', por
+// exemplo, o 'buffer' dos elementos é liberado pelo destrutor, e o que
+// permanece são apenas os 24 bytes do próprio objeto 'std::vector'. O
+// problema aparece de fato em tipos com armazenamento interno grande
+// ('std::array', 'buffers' inline, 'Widgets' com membros extensos).
+
+// Quantidade de bytes de objetos já destruídos cuja memória ainda está retida
+// apenas por referências 'std::weak_ptr'. Contabiliza somente os objetos
+// criados por 'make_shared_tracked'/'make_shared_weak_aware'.
+inline std::atomic<std::size_t> weak_retained_bytes_counter{0};
+
+inline std::size_t weak_retained_bytes() {
+    return weak_retained_bytes_counter.load(std::memory_order_relaxed);
+}
+
+// Alocador utilizado por 'std::allocate_shared' para instrumentar o bloco
+// único. 'Payload' é mantido durante o 'rebind' para o tipo interno do
+// 'control block', de forma que se saiba o tamanho do objeto nas duas pontas:
+// - '.destroy()' é chamado quando o último 'std::shared_ptr' é destruído: a
+//   partir deste ponto, os bytes do objeto estão retidos apenas pelos
+//   'std::weak_ptr';
+// - '.deallocate()' é chamado quando o 'control block' é liberado.
+template <typename U, typename Payload>
+struct weak_tracking_allocator {
+    using value_type = U;
+
+    template <typename V>
+    struct rebind {
+        using other = weak_tracking_allocator<V, Payload>;
+    };
+
+    weak_tracking_allocator() = default;
+    template <typename V>
+    weak_tracking_allocator(const weak_tracking_allocator<V, Payload>&) {}
+
+    U* allocate(std::size_t n) {
+        return static_cast<U*>(::operator new(n * sizeof(U)));
+    }
+    void deallocate(U* p, std::size_t n) {
+        weak_retained_bytes_counter.fetch_sub(sizeof(Payload),
+                                              std::memory_order_relaxed);
+        ::operator delete(p, n * sizeof(U));
+    }
+
+    template <typename V, typename... Args>
+    void construct(V* p, Args&&... args) {
+        try {
+            ::new (static_cast<void*>(p)) V(std::forward<Args>(args)...);
+        } catch (...) {
+            // Mantém o balanço com o '.deallocate()' que se seguirá.
+            weak_retained_bytes_counter.fetch_add(sizeof(Payload),
+                                                  std::memory_order_relaxed);
+            throw;
+        }
+    }
+    template <typename V>
+    void destroy(V* p) {
+        p->~V();
+        weak_retained_bytes_counter.fetch_add(sizeof(Payload),
+                                              std::memory_order_relaxed);
+    }
+
+    template <typename V>
+    bool operator==(const weak_tracking_allocator<V, Payload>&) const {
+        return true;
+    }
+};
+
+// Equivalente a 'std::make_shared' (alocação única), porém com a retenção
+// por 'std::weak_ptr' contabilizada em 'weak_retained_bytes()'.
+template <typename T, typename... Args>
+std::shared_ptr<T> make_shared_tracked(Args&&... args) {
+    return std::allocate_shared<T>(weak_tracking_allocator<T, T>{},
+                                   std::forward<Args>(args)...);
+}
+
+// Fábrica para objetos que serão observados por 'std::weak_ptr': abaixo de
+// 'SplitThreshold' bytes, a alocação única de 'std::make_shared' compensa; a
+// partir deste tamanho, objeto e 'control block' são alocados separadamente,
+// de forma que a memória do objeto seja devolvida assim que o último
+// 'std::shared_ptr' for destruído, independente dos 'std::weak_ptr'.
+template <typename T, std::size_t SplitThreshold = 1024, typename... Args>
+std::shared_ptr<T> make_shared_weak_aware(Args&&... args) {
+    if constexpr (sizeof(T) >= SplitThreshold) {
+        return std::shared_ptr<T>(new T(std::forward<Args>(args)...));
+    } else {
+        return make_shared_tracked<T>(std::forward<Args>(args)...);
+    }
+}